@@ -0,0 +1,77 @@
+#include "app_events.h"
+#include <benchmark/benchmark.h>
+#include <thread>
+
+// post to dispatch on the host, through the FreeRTOS stubs; the allocation check is in test_allocations.cpp
+
+namespace
+{
+std::atomic<uint32_t> handled{0};
+
+void count_update(void *, int32_t, const avr_state_update &)
+{
+    handled.fetch_add(1, std::memory_order_release);
+}
+
+void wait_until_handled(uint32_t count)
+{
+    while (handled.load(std::memory_order_acquire) < count)
+    {
+        std::this_thread::yield();
+    }
+}
+
+app_event_bus &started_bus()
+{
+    static const bool started = [] {
+        static app_event_subscriber_typed<avr_state_update> subscriber(AVR_STATE_CHANGED, count_update, nullptr);
+        const auto started = app_event_bus::instance().begin(4096, 5, 0) == ESP_OK;
+        subscriber.subscribe();
+        return started;
+    }();
+    benchmark::DoNotOptimize(started);
+    return app_event_bus::instance();
+}
+
+// one event at a time, from post until the subscriber ran
+void BM_post_to_handler(benchmark::State &state)
+{
+    auto &bus = started_bus();
+    const avr_state_update update{};
+    auto expected = handled.load();
+    for (auto _ : state)
+    {
+        if (bus.post(AVR_STATE_CHANGED, update, app_event_bus::lane::priority) == ESP_OK)
+        {
+            expected++;
+        }
+        wait_until_handled(expected);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_post_to_handler);
+
+// a burst filling the lane, then waiting until all of it is dispatched
+void BM_post_burst(benchmark::State &state)
+{
+    auto &bus = started_bus();
+    const avr_state_update update{};
+    auto expected = handled.load();
+    size_t posted = 0;
+    for (auto _ : state)
+    {
+        for (int i = 0; i < state.range(0); i++)
+        {
+            if (bus.post(AVR_STATE_CHANGED, update, app_event_bus::lane::normal) == ESP_OK)
+            {
+                expected++;
+                posted++;
+            }
+        }
+        wait_until_handled(expected);
+    }
+    state.SetItemsProcessed(posted);
+    state.counters["dropped"] = bus.get_dropped_events();
+}
+BENCHMARK(BM_post_burst)->Arg(4)->Arg(16);
+} // namespace
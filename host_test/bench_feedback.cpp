@@ -0,0 +1,56 @@
+#include "display_renderer.h"
+#include "hardware/display/feedback_decoder.h"
+#include "hardware/uart/avr_state_parser.h"
+#include "hardware/uart/command_processor.h"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace
+{
+// one frame of every command type the display reacts to
+constexpr std::array<std::string_view, 8> sample_frames{
+    "PWON", "PWSTANDBY", "MV455", "MVMAX 98", "MUON", "PSDYNVOL MED", "SIBD", "MSDOLBY DIGITAL",
+};
+
+void BM_frames_through_parser(benchmark::State &state)
+{
+    std::string stream;
+    for (auto &&frame : sample_frames)
+    {
+        stream.append(frame).push_back('\r');
+    }
+
+    command_processor processor;
+    command_processor::frame frame;
+    size_t frames = 0;
+    for (auto _ : state)
+    {
+        processor.add_data(stream);
+        while (processor.pop_command(frame))
+        {
+            benchmark::DoNotOptimize(avr_state_parser::parse(frame.view()));
+            frames++;
+        }
+    }
+    state.SetItemsProcessed(frames);
+}
+BENCHMARK(BM_frames_through_parser);
+
+void BM_decode_to_render(benchmark::State &state)
+{
+    const auto frame = sample_frames[state.range(0)];
+    state.SetLabel(std::string(frame));
+    display_renderer renderer;
+    for (auto _ : state)
+    {
+        const auto delta = avr_state_parser::parse(frame);
+        const auto value = delta.has_value() ? feedback_decoder::decode(*delta) : std::nullopt;
+        if (value.has_value())
+        {
+            benchmark::DoNotOptimize(renderer.render(*value).to_module_rows());
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_decode_to_render)->DenseRange(0, sample_frames.size() - 1);
+} // namespace
@@ -0,0 +1,47 @@
+#include "util/hash/hash.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+// SHA-256 through the digest API on the host, backed by OpenSSL; on target mbedtls uses the SHA accelerator
+
+namespace
+{
+std::vector<uint8_t> input(size_t size)
+{
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++)
+    {
+        data[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    return data;
+}
+
+void BM_sha256_compute(benchmark::State &state)
+{
+    const auto data = input(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(esp32::hash::sha256(std::span<const uint8_t>(data)));
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_sha256_compute)->Arg(64)->Arg(4096)->Arg(1 << 20);
+
+// 1 MiB in chunks of the given size, like ota_updator hashes what it writes
+void BM_sha256_update_chunked(benchmark::State &state)
+{
+    const auto data = input(1 << 20);
+    const auto chunk_size = static_cast<size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        esp32::hash::hash<MBEDTLS_MD_SHA256> hash;
+        for (size_t offset = 0; offset < data.size(); offset += chunk_size)
+        {
+            hash.update(data.data() + offset, std::min(chunk_size, data.size() - offset));
+        }
+        benchmark::DoNotOptimize(hash.finish());
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_sha256_update_chunked)->Arg(64)->Arg(1024)->Arg(4096);
+} // namespace
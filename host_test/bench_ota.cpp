@@ -0,0 +1,53 @@
+#include "firmware_image.h"
+#include "host_flash.h"
+#include "lzss_encoder.h"
+#include "util/ota.h"
+#include <benchmark/benchmark.h>
+
+// write and end of ota_updator on the in-memory flash, without and with reading the image back;
+// on the host the flash costs nothing, so this is the cost of hashing, copying and decompressing
+
+namespace
+{
+constexpr size_t chunk_size = 4096;
+
+void update(benchmark::State &state, esp32::ota_updator::encoding encoding, bool verify_flash)
+{
+    const auto image = firmware_image(state.range(0));
+    const auto expected = esp32::hash::sha256(std::span<const uint8_t>(image));
+    const auto input = encoding == esp32::ota_updator::encoding::lzss ? lzss_encode<10, 5>(image) : image;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        host_flash::reset();
+        state.ResumeTiming();
+
+        esp32::ota_updator updator(expected, encoding);
+        for (size_t offset = 0; offset < input.size(); offset += chunk_size)
+        {
+            updator.write(input.data() + offset, std::min(chunk_size, input.size() - offset));
+        }
+        updator.end(verify_flash);
+    }
+    state.SetBytesProcessed(state.iterations() * image.size());
+}
+
+void BM_ota_write_end(benchmark::State &state)
+{
+    update(state, esp32::ota_updator::encoding::raw, false);
+}
+BENCHMARK(BM_ota_write_end)->Arg(256 << 10)->Arg(1 << 20);
+
+void BM_ota_write_end_read_back(benchmark::State &state)
+{
+    update(state, esp32::ota_updator::encoding::raw, true);
+}
+BENCHMARK(BM_ota_write_end_read_back)->Arg(256 << 10)->Arg(1 << 20);
+
+void BM_ota_lzss_write_end(benchmark::State &state)
+{
+    update(state, esp32::ota_updator::encoding::lzss, false);
+}
+BENCHMARK(BM_ota_lzss_write_end)->Arg(256 << 10)->Arg(1 << 20);
+} // namespace
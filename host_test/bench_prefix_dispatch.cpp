@@ -0,0 +1,116 @@
+#include "denon_commands.h"
+#include "util/prefix_dispatch.h"
+#include <benchmark/benchmark.h>
+
+namespace
+{
+enum class command
+{
+    none,
+    mute_on,
+    mute_off,
+    power_off,
+    power_on,
+    volume,
+    dynamic_volume,
+};
+
+// the if/else chain display::app_event_handler walked before prefix_dispatch
+command old_chain(std::string_view feedback_string)
+{
+    if (feedback_string == "MUON")
+    {
+        return command::mute_on;
+    }
+    else if (feedback_string == "MUOFF")
+    {
+        return command::mute_off;
+    }
+    else if (feedback_string == "PWSTANDBY")
+    {
+        return command::power_off;
+    }
+    else if (feedback_string == "PWON")
+    {
+        return command::power_on;
+    }
+    else if (feedback_string.starts_with("MV"))
+    {
+        return feedback_string.starts_with("MVMAX") ? command::none : command::volume;
+    }
+    else if (feedback_string.starts_with("PSDYNVOL"))
+    {
+        return command::dynamic_volume;
+    }
+    return command::none;
+}
+
+constexpr esp32::prefix_dispatch<command, 6> feedback_dispatch{{{
+    {"MUON", command::mute_on},
+    {"MUOFF", command::mute_off},
+    {"PWSTANDBY", command::power_off},
+    {"PWON", command::power_on},
+    {"MV", command::volume},
+    {"PSDYNVOL", command::dynamic_volume},
+}}};
+
+command dispatch(std::string_view feedback)
+{
+    const auto entry = feedback_dispatch.find(feedback);
+    return entry ? entry->handler : command::none;
+}
+
+// what the chain turns into for the whole protocol: one starts_with per prefix, longest first
+constexpr auto denon_chain = [] {
+    auto prefixes = denon_command_prefixes;
+    std::sort(prefixes.begin(), prefixes.end(), [](auto a, auto b) { return a.size() > b.size(); });
+    return prefixes;
+}();
+
+size_t full_chain(std::string_view feedback)
+{
+    for (size_t i = 0; i < denon_chain.size(); i++)
+    {
+        if (feedback.starts_with(denon_chain[i]))
+        {
+            return i;
+        }
+    }
+    return denon_chain.size();
+}
+
+constexpr esp32::prefix_dispatch<size_t, denon_command_prefixes.size()> denon_dispatch{
+    make_handlers<size_t>(denon_command_prefixes, [](size_t i) { return i; })};
+
+size_t full_dispatch(std::string_view feedback)
+{
+    const auto entry = denon_dispatch.find(feedback);
+    return entry ? entry->handler : denon_command_prefixes.size();
+}
+
+constexpr std::array<std::string_view, 8> feedback_frames{
+    "PWON", "PWSTANDBY", "MV455", "MVMAX 98", "MUON", "PSDYNVOL MED", "SIBD", "MSDOLBY DIGITAL",
+};
+
+constexpr std::array<std::string_view, 8> protocol_frames{
+    "MV455", "CVFL 50", "SIMPLAY", "MSDOLBY ATMOS", "PSREFLEV 5", "Z2CV FL 50", "NSE1Now Playing", "SSINFAISSIG 02",
+};
+
+template <auto F, const auto &frames> void BM_lookup(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        for (auto frame : frames)
+        {
+            benchmark::DoNotOptimize(frame);
+            benchmark::DoNotOptimize(F(frame));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * frames.size());
+}
+
+BENCHMARK(BM_lookup<old_chain, feedback_frames>)->Name("feedback/old_chain");
+BENCHMARK(BM_lookup<dispatch, feedback_frames>)->Name("feedback/prefix_dispatch");
+BENCHMARK(BM_lookup<full_chain, protocol_frames>)->Name("protocol/chain");
+BENCHMARK(BM_lookup<full_dispatch, protocol_frames>)->Name("protocol/prefix_dispatch");
+} // namespace
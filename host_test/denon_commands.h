@@ -0,0 +1,59 @@
+#pragma once
+
+#include "util/prefix_dispatch.h"
+#include <array>
+#include <string_view>
+
+// Command prefixes from the Denon AVR control protocol, across all its command groups
+constexpr std::array<std::string_view, 261> denon_command_prefixes{
+    // power, master volume, mute
+    "PWON", "PWSTANDBY", "MVUP", "MVDOWN", "MVMAX", "MV", "MUON", "MUOFF",
+    // channel volume
+    "CVFL", "CVFR", "CVC", "CVSW", "CVSW2", "CVSL", "CVSR", "CVSBL", "CVSBR", "CVSB", "CVFHL", "CVFHR", "CVFWL", "CVFWR",
+    "CVTFL", "CVTFR", "CVTML", "CVTMR", "CVTRL", "CVTRR", "CVRHL", "CVRHR", "CVFDL", "CVFDR", "CVSDL", "CVSDR", "CVBDL",
+    "CVBDR", "CVSHL", "CVSHR", "CVTS", "CVZRL", "CVEND",
+    // input source
+    "SIPHONO", "SICD", "SITUNER", "SIDVD", "SIBD", "SITV", "SISAT/CBL", "SIMPLAY", "SIGAME", "SIHDRADIO", "SINET",
+    "SIPANDORA", "SISIRIUSXM", "SISPOTIFY", "SILASTFM", "SIFLICKR", "SIIRADIO", "SISERVER", "SIFAVORITES", "SIAUX1",
+    "SIAUX2", "SIAUX3", "SIAUX4", "SIAUX5", "SIAUX6", "SIAUX7", "SIBT", "SIUSB/IPOD", "SIUSB", "SIIPD", "SIIRP", "SIFVP",
+    // main zone, video select, sleep
+    "ZMON", "ZMOFF", "ZMFAVORITE1", "ZMFAVORITE2", "ZMFAVORITE3", "ZMFAVORITE4", "SVDVD", "SVBD", "SVTV", "SVSAT/CBL",
+    "SVMPLAY", "SVGAME", "SVAUX1", "SVAUX2", "SVCD", "SVSOURCE", "SVON", "SVOFF", "SLPOFF", "SLP",
+    // surround mode
+    "MSMOVIE", "MSMUSIC", "MSGAME", "MSDIRECT", "MSPURE DIRECT", "MSSTEREO", "MSAUTO", "MSDOLBY DIGITAL",
+    "MSDOLBY PRO LOGIC", "MSDOLBY ATMOS", "MSDTS SURROUND", "MSDTS:X", "MSAURO3D", "MSAURO2DSURR", "MSMCH STEREO",
+    "MSWIDE SCREEN", "MSSUPER STADIUM", "MSROCK ARENA", "MSJAZZ CLUB", "MSCLASSIC CONCERT", "MSMONO MOVIE", "MSMATRIX",
+    "MSVIDEO GAME", "MSVIRTUAL", "MSLEFT", "MSRIGHT", "MSQUICK1", "MSQUICK2", "MSQUICK3", "MSQUICK4", "MSQUICK5",
+    // video
+    "VSMONI1", "VSMONI2", "VSMONIAUTO", "VSASP", "VSSC", "VSSCH", "VSAUDIO", "VSVPM", "VSVST",
+    // parameters
+    "PSTONE CTRL", "PSBAS", "PSTRE", "PSLOM", "PSCLV", "PSSWL", "PSDYNEQ", "PSREFLEV", "PSDYNVOL", "PSMULTEQ", "PSDRC",
+    "PSDEL", "PSLFE", "PSEFF", "PSBSC", "PSRSZ", "PSCINEMA EQ.", "PSMODE:", "PSFH:", "PSPHG", "PSSP:", "PSLFC",
+    "PSCNTAMT", "PSDIL", "PSGEQ", "PSAUROPR", "PSAUROST", "PSSWR", "PSDIC", "PSSTW", "PSSTH", "PSCEN", "PSCEI", "PSCEG",
+    "PSPAN", "PSDIM", "PSHEQ", "PSNEURAL", "PSAFD",
+    // picture
+    "PVPICT", "PVCN", "PVBR", "PVST", "PVCM", "PVHUE", "PVDNR", "PVENH",
+    // zone 2 and 3
+    "Z2ON", "Z2OFF", "Z2MU", "Z2CS", "Z2CV", "Z2HPF", "Z2PS", "Z2SLP", "Z2QUICK", "Z2", "Z3ON", "Z3OFF", "Z3MU", "Z3CS",
+    "Z3CV", "Z3HPF", "Z3PS", "Z3SLP", "Z3QUICK", "Z3",
+    // tuner, hd radio, network
+    "TFANNAME", "TFAN", "TFHD", "TPAN", "TPHD", "TMAN", "TMFM", "TMAM", "TMDA", "HDST", "HDPT", "NSE", "NSA", "NSH",
+    "NS9", "DAPRESET", "DASTN",
+    // status, system, menu
+    "SSINFAISSIG", "SSINFAISFSV", "SSLAN", "SSSMG", "SSSOD", "SYMO", "SYREMOTE LOCK", "SYPANEL LOCK", "UGIDN", "DCAUTO",
+    "DCPCM", "DCDTS", "SDAUTO", "SDHDMI", "SDDIGITAL", "SDANALOG", "SDEXT.IN", "SDNO", "DIM BRI", "DIM DIM", "DIM DAR",
+    "DIM OFF", "ECOON", "ECOAUTO", "ECOOFF", "STBY", "BTTX", "BTRX", "TR1", "TR2", "MNCUP", "MNCDN", "MNCLT", "MNCRT",
+    "MNENT", "MNRTN", "MNOPT", "MNINF", "MNMEN", "MNCHL", "MNSRC", "MNZST", "SPPR", "SPFW",
+};
+
+// pairs every prefix with handler_for(its index)
+template <typename H, size_t N, typename F>
+constexpr std::array<esp32::prefix_handler<H>, N> make_handlers(const std::array<std::string_view, N> &prefixes, F &&handler_for)
+{
+    std::array<esp32::prefix_handler<H>, N> handlers{};
+    for (size_t i = 0; i < N; i++)
+    {
+        handlers[i] = {prefixes[i], handler_for(i)};
+    }
+    return handlers;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "hardware/display/compositor.h"
+#include "hardware/display/display_value.h"
+#include "hardware/display/screens.h"
+#include "hardware/display/text_renderer.h"
+#include "hardware/display/volume_bar.h"
+#include <algorithm>
+#include <array>
+#include <span>
+#include <variant>
+
+/**
+ * The drawing display::update_display_based_on_display_value and its show_* helpers do, without the
+ * timers, the animations and the spi transfer. Volume and text are drawn at their final position,
+ * scroll_text draws the window of text scrolled by some columns.
+ */
+class display_renderer
+{
+  public:
+    explicit display_renderer(bool with_volume_bar = true) : with_volume_bar_(with_volume_bar)
+    {
+    }
+
+    frame_buffer render(const display_state::value &value)
+    {
+        using namespace display_state;
+        using layer = compositor::layer_id;
+        layers_.clear_all();
+
+        std::visit(
+            [this](auto &&state) {
+                using T = std::decay_t<decltype(state)>;
+                if constexpr (std::is_same_v<T, ScreenBrightnessLevel>)
+                {
+                    layers_.set(layer::base, screens::all_on);
+                }
+                else if constexpr (std::is_same_v<T, FourChars>)
+                {
+                    layers_.set(layer::base, screens::four_chars(state.value));
+                }
+                else if constexpr (std::is_same_v<T, Volume>)
+                {
+                    if (with_volume_bar_)
+                    {
+                        layers_.set(layer::bar, volume_bar::frame(bar_.position(state.half_db)));
+                    }
+                    else
+                    {
+                        layers_.set(layer::base, screens::volume_digits(state.half_db));
+                    }
+                }
+                else if constexpr (std::is_same_v<T, Text>)
+                {
+                    text_width_ = text_renderer::render(state.value.view(), text_columns_);
+                    draw_text(text_width_ <= frame_buffer::width ? static_cast<int>(frame_buffer::width - text_width_) / 2 : 0);
+                }
+                else if constexpr (std::is_same_v<T, MuteOn>)
+                {
+                    layers_.set(layer::base, screens::mute_on);
+                }
+                else if constexpr (std::is_same_v<T, PowerOff>)
+                {
+                    layers_.set(layer::base, screens::power_off);
+                }
+                else if constexpr (std::is_same_v<T, DynVol>)
+                {
+                    layers_.set(layer::base, screens::dyn_vol_label);
+                    layers_.set(layer::overlay, screens::dyn_vol_levels[state.value], blend_op::replace, screens::dyn_vol_level_columns);
+                }
+            },
+            value);
+        return layers_.compose();
+    }
+
+    /**
+     * The frame of the last rendered text after scrolling it left by offset columns.
+     */
+    frame_buffer scroll_text(size_t offset)
+    {
+        draw_text(-static_cast<int>(offset));
+        return layers_.compose();
+    }
+
+  private:
+    bool with_volume_bar_;
+    compositor layers_;
+    volume_bar bar_;
+    std::array<uint8_t, 192> text_columns_{};
+    size_t text_width_{0};
+
+    void draw_text(int x)
+    {
+        frame_buffer frame;
+        frame.blit(std::span<const uint8_t>(text_columns_.data(), text_width_), x);
+        layers_.set(compositor::layer_id::base, frame);
+    }
+};
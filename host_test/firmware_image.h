@@ -0,0 +1,24 @@
+#pragma once
+
+#include <algorithm>
+#include <random>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Stand-in for an application image: long runs of padding between random looking code.
+ */
+inline std::vector<uint8_t> firmware_image(size_t size)
+{
+    std::vector<uint8_t> image(size, 0xff);
+    std::mt19937 random(7);
+    for (size_t i = 0; i < size; i += 1024)
+    {
+        for (size_t j = i; j < std::min(size, i + 700); j++)
+        {
+            image[j] = static_cast<uint8_t>(random());
+        }
+    }
+    return image;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Greedy heatshrink compatible encoder, the counterpart of esp32::lzss_decoder for the tests.
+ *
+ * Slow but simple: every position searches the whole window for the longest match.
+ */
+template <uint8_t WindowBits, uint8_t LookaheadBits> std::vector<uint8_t> lzss_encode(std::span<const uint8_t> input)
+{
+    constexpr size_t window_size = size_t{1} << WindowBits;
+    constexpr size_t max_length = size_t{1} << LookaheadBits;
+    // a back reference only pays off from this length on
+    constexpr size_t min_length = (1 + WindowBits + LookaheadBits) / 9 + 1;
+
+    std::vector<uint8_t> output;
+    uint32_t bits = 0;
+    uint8_t bit_count = 0;
+    const auto put = [&](uint32_t value, uint8_t count) {
+        for (auto i = count; i > 0; i--)
+        {
+            bits = (bits << 1) | ((value >> (i - 1)) & 1);
+            if (++bit_count == 8)
+            {
+                output.push_back(static_cast<uint8_t>(bits));
+                bits = 0;
+                bit_count = 0;
+            }
+        }
+    };
+
+    size_t position = 0;
+    while (position < input.size())
+    {
+        size_t best_length = 0;
+        size_t best_distance = 0;
+        for (size_t distance = 1; distance <= std::min(window_size, position); distance++)
+        {
+            size_t length = 0;
+            while (length < max_length && position + length < input.size() &&
+                   input[position + length] == input[position + length - distance])
+            {
+                length++;
+            }
+            if (length > best_length)
+            {
+                best_length = length;
+                best_distance = distance;
+            }
+        }
+
+        if (best_length >= min_length)
+        {
+            put(0, 1);
+            put(static_cast<uint32_t>(best_distance - 1), WindowBits);
+            put(static_cast<uint32_t>(best_length - 1), LookaheadBits);
+            position += best_length;
+        }
+        else
+        {
+            put(1, 1);
+            put(input[position], 8);
+            position++;
+        }
+    }
+
+    if (bit_count)
+    {
+        put(0, 8 - bit_count);
+    }
+    return output;
+}
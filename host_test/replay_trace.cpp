@@ -0,0 +1,47 @@
+// Replays a UART trace recorded with RECORD_UART_TRACE through the feedback path and reports
+// throughput and the latency of every stage.
+//
+//   replay_trace <trace> [speed]
+//
+// The trace is either the binary capture or the log denon_avr::log_trace wrote: the hex lines between
+// "UART trace begin" and "UART trace end", with or without the log prefix in front of them.
+// speed 1 replays at the recorded pace, 10 ten times faster, 0 (the default) as fast as possible.
+
+#include "trace_replayer.h"
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "usage: %s <trace> [speed]\n", argv[0]);
+        return 2;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file)
+    {
+        fprintf(stderr, "can not open %s\n", argv[1]);
+        return 2;
+    }
+    const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    auto trace = std::vector<uint8_t>(content.begin(), content.end());
+    if (!uart_trace::reader(trace).is_valid())
+    {
+        trace = trace_replayer::from_log(content);
+    }
+
+    trace_replayer replayer(argc > 2 ? std::strtod(argv[2], nullptr) : 0);
+    const auto complete = replayer.replay(trace);
+    replayer.print_report(stdout);
+    if (!complete)
+    {
+        fprintf(stderr, "trace is not valid or truncated after %zu records\n", replayer.records());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,223 @@
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+#include "host_flash.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+constexpr size_t partition_size = 0x1e0000;
+constexpr esp_ota_handle_t ota_handle = 1;
+
+const esp_partition_t update_partition{
+    .type = ESP_PARTITION_TYPE_APP,
+    .subtype = ESP_PARTITION_SUBTYPE_APP_OTA_1,
+    .address = 0x200000,
+    .size = partition_size,
+    .label = "app1",
+};
+
+std::mutex flash_lock;
+std::condition_variable writes_released;
+bool writes_held = false;
+std::vector<uint8_t> flash(partition_size, 0xff);
+size_t write_offset = 0;
+bool ota_running = false;
+bool boot_partition_set = false;
+std::chrono::microseconds write_delay{0};
+size_t fail_after = SIZE_MAX;
+
+const esp_partition_t running_partition{
+    .type = ESP_PARTITION_TYPE_APP,
+    .subtype = ESP_PARTITION_SUBTYPE_APP_OTA_0,
+    .address = 0x20000,
+    .size = partition_size,
+    .label = "app0",
+};
+esp_ota_img_states_t running_state = ESP_OTA_IMG_VALID;
+} // namespace
+
+namespace host_flash
+{
+void reset()
+{
+    std::lock_guard lock(flash_lock);
+    std::fill(flash.begin(), flash.end(), 0xff);
+    write_offset = 0;
+    ota_running = false;
+    boot_partition_set = false;
+    write_delay = {};
+    writes_held = false;
+    fail_after = SIZE_MAX;
+    running_state = ESP_OTA_IMG_VALID;
+    writes_released.notify_all();
+}
+
+std::vector<uint8_t> written_image()
+{
+    std::lock_guard lock(flash_lock);
+    return std::vector<uint8_t>(flash.begin(), flash.begin() + write_offset);
+}
+
+bool is_boot_partition_set()
+{
+    std::lock_guard lock(flash_lock);
+    return boot_partition_set;
+}
+
+void set_write_delay(std::chrono::microseconds delay)
+{
+    std::lock_guard lock(flash_lock);
+    write_delay = delay;
+}
+
+void hold_writes(bool hold)
+{
+    std::lock_guard lock(flash_lock);
+    writes_held = hold;
+    writes_released.notify_all();
+}
+
+void fail_writes_after(size_t bytes)
+{
+    std::lock_guard lock(flash_lock);
+    fail_after = bytes;
+}
+
+void set_running_image_state(esp_ota_img_states_t state)
+{
+    std::lock_guard lock(flash_lock);
+    running_state = state;
+}
+
+esp_ota_img_states_t running_image_state()
+{
+    std::lock_guard lock(flash_lock);
+    return running_state;
+}
+
+void corrupt(size_t offset)
+{
+    std::lock_guard lock(flash_lock);
+    flash.at(offset) ^= 0xff;
+}
+} // namespace host_flash
+
+const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *)
+{
+    return &update_partition;
+}
+
+esp_err_t esp_ota_begin(const esp_partition_t *partition, size_t, esp_ota_handle_t *out_handle)
+{
+    std::lock_guard lock(flash_lock);
+    if (partition != &update_partition || ota_running)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::fill(flash.begin(), flash.end(), 0xff);
+    write_offset = 0;
+    ota_running = true;
+    *out_handle = ota_handle;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_write(esp_ota_handle_t handle, const void *data, size_t size)
+{
+    std::chrono::microseconds delay;
+    {
+        std::lock_guard lock(flash_lock);
+        delay = write_delay;
+    }
+    std::this_thread::sleep_for(delay);
+
+    std::unique_lock lock(flash_lock);
+    writes_released.wait(lock, [] { return !writes_held; });
+    if (handle != ota_handle || !ota_running)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (write_offset + size > fail_after)
+    {
+        return ESP_FAIL;
+    }
+    if (write_offset + size > flash.size())
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(flash.data() + write_offset, data, size);
+    write_offset += size;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_end(esp_ota_handle_t handle)
+{
+    std::lock_guard lock(flash_lock);
+    if (handle != ota_handle || !ota_running)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    ota_running = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_abort(esp_ota_handle_t handle)
+{
+    return esp_ota_end(handle);
+}
+
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t *partition)
+{
+    std::lock_guard lock(flash_lock);
+    if (partition != &update_partition)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    boot_partition_set = true;
+    return ESP_OK;
+}
+
+const esp_partition_t *esp_ota_get_running_partition()
+{
+    return &running_partition;
+}
+
+esp_err_t esp_ota_get_state_partition(const esp_partition_t *partition, esp_ota_img_states_t *ota_state)
+{
+    std::lock_guard lock(flash_lock);
+    if (partition != &running_partition)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *ota_state = running_state;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_mark_app_valid_cancel_rollback()
+{
+    std::lock_guard lock(flash_lock);
+    running_state = ESP_OTA_IMG_VALID;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_mark_app_invalid_rollback_and_reboot()
+{
+    std::lock_guard lock(flash_lock);
+    running_state = ESP_OTA_IMG_INVALID;
+    return ESP_FAIL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size)
+{
+    std::lock_guard lock(flash_lock);
+    if (partition != &update_partition || src_offset + size > flash.size())
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(dst, flash.data() + src_offset, size);
+    return ESP_OK;
+}
@@ -0,0 +1,87 @@
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace
+{
+std::mutex log_lock;
+esp_log_level_t default_level = ESP_LOG_WARN;
+std::map<std::string, esp_log_level_t> tag_levels;
+
+const auto start_time = std::chrono::steady_clock::now();
+} // namespace
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code)
+    {
+    case ESP_OK:
+        return "ESP_OK";
+    case ESP_FAIL:
+        return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:
+        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:
+        return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:
+        return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:
+        return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:
+        return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:
+        return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:
+        return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_RESPONSE:
+        return "ESP_ERR_INVALID_RESPONSE";
+    case ESP_ERR_INVALID_CRC:
+        return "ESP_ERR_INVALID_CRC";
+    default:
+        return "UNKNOWN ERROR";
+    }
+}
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    std::lock_guard guard(log_lock);
+    if (std::string(tag) == "*")
+    {
+        default_level = level;
+        tag_levels.clear();
+    }
+    else
+    {
+        tag_levels[tag] = level;
+    }
+}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    std::lock_guard guard(log_lock);
+    const auto tag_level = tag_levels.find(tag);
+    if (level > (tag_level != tag_levels.end() ? tag_level->second : default_level))
+    {
+        return;
+    }
+
+    constexpr static char level_letters[] = "NEWIDV";
+    fprintf(stderr, "%c (%s) ", level_letters[level], tag);
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+int64_t esp_timer_get_time()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+}
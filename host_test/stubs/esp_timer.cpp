@@ -0,0 +1,173 @@
+#include "esp_timer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// like esp_timer, one task runs the callbacks of all timers; starting, stopping and restarting only
+// update the timer under the lock, so they do not allocate either
+struct esp_timer
+{
+    esp_timer_create_args_t args;
+    bool active;
+    int64_t alarm_us;
+    uint64_t period_us;
+};
+
+namespace
+{
+struct timer_service
+{
+    std::mutex lock;
+    std::condition_variable changed;
+    std::vector<esp_timer *> timers;
+    std::once_flag started;
+
+    void run()
+    {
+        std::unique_lock guard(lock);
+        for (;;)
+        {
+            const auto next = next_alarm();
+            const auto now = esp_timer_get_time();
+            if (next > now)
+            {
+                if (next == INT64_MAX)
+                {
+                    changed.wait(guard);
+                }
+                else
+                {
+                    changed.wait_for(guard, std::chrono::microseconds(next - now));
+                }
+                continue;
+            }
+
+            for (auto timer : timers)
+            {
+                if (timer->active && timer->alarm_us <= now)
+                {
+                    if (timer->period_us)
+                    {
+                        timer->alarm_us += timer->period_us;
+                    }
+                    else
+                    {
+                        timer->active = false;
+                    }
+                    const auto callback = timer->args.callback;
+                    const auto arg = timer->args.arg;
+                    guard.unlock();
+                    callback(arg);
+                    guard.lock();
+                    // the list may have changed during the callback
+                    break;
+                }
+            }
+        }
+    }
+
+    int64_t next_alarm() const
+    {
+        int64_t next = INT64_MAX;
+        for (auto timer : timers)
+        {
+            if (timer->active)
+            {
+                next = std::min(next, timer->alarm_us);
+            }
+        }
+        return next;
+    }
+
+    esp_err_t start(esp_timer_handle_t timer, uint64_t timeout_us, uint64_t period_us, bool restart)
+    {
+        std::lock_guard guard(lock);
+        if (timer->active != restart)
+        {
+            return ESP_ERR_INVALID_STATE;
+        }
+        timer->active = true;
+        timer->alarm_us = esp_timer_get_time() + static_cast<int64_t>(timeout_us);
+        // a restarted periodic timer keeps running with the new period
+        timer->period_us = restart ? (timer->period_us ? timeout_us : 0) : period_us;
+        changed.notify_all();
+        return ESP_OK;
+    }
+};
+
+// never destroyed, the service thread keeps using it until the process exits
+timer_service &service = *new timer_service;
+} // namespace
+
+int64_t esp_timer_get_next_alarm()
+{
+    std::lock_guard guard(service.lock);
+    return service.next_alarm();
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    if (!create_args || !create_args->callback || !out_handle)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::call_once(service.started, [] { std::thread([] { service.run(); }).detach(); });
+
+    std::lock_guard guard(service.lock);
+    *out_handle = new esp_timer{*create_args, false, 0, 0};
+    service.timers.push_back(*out_handle);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    return service.start(timer, timeout_us, 0, false);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    return service.start(timer, period, period, false);
+}
+
+esp_err_t esp_timer_restart(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    return service.start(timer, timeout_us, 0, true);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    std::lock_guard guard(service.lock);
+    if (!timer->active)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->active = false;
+    service.changed.notify_all();
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    if (!timer)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard guard(service.lock);
+    if (timer->active)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    std::erase(service.timers, timer);
+    delete timer;
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+    std::lock_guard guard(service.lock);
+    return timer->active;
+}
@@ -0,0 +1,209 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+struct host_task
+{
+    std::thread thread;
+    std::atomic<bool> deleted{false};
+    uint32_t notifications{0};
+};
+
+namespace
+{
+// one lock for all queues and delays, good enough for tests
+std::mutex lock;
+std::condition_variable changed;
+thread_local host_task *current_task = nullptr;
+
+// thrown into a task that was deleted while blocked, unwinds it back to its thread function
+struct task_deleted
+{
+};
+
+bool is_deleted()
+{
+    return current_task != nullptr && current_task->deleted;
+}
+
+template <typename Predicate> bool wait(std::unique_lock<std::mutex> &guard, TickType_t ticks, Predicate predicate)
+{
+    const auto done = [&] { return is_deleted() || predicate(); };
+    if (ticks == portMAX_DELAY)
+    {
+        changed.wait(guard, done);
+    }
+    else
+    {
+        changed.wait_for(guard, std::chrono::milliseconds(ticks), done);
+    }
+
+    if (is_deleted())
+    {
+        throw task_deleted{};
+    }
+    return predicate();
+}
+} // namespace
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint32_t stack_depth, void *parameters, UBaseType_t priority,
+                       TaskHandle_t *created_task)
+{
+    return xTaskCreatePinnedToCore(function, name, stack_depth, parameters, priority, created_task, tskNO_AFFINITY);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *, uint32_t, void *parameters, UBaseType_t, TaskHandle_t *created_task,
+                                   BaseType_t)
+{
+    auto task = new host_task;
+    // held until the handle is complete, in case the task deletes itself right away
+    std::lock_guard guard(lock);
+    task->thread = std::thread([task, function, parameters] {
+        {
+            std::lock_guard started(lock);
+            current_task = task;
+        }
+        try
+        {
+            function(parameters);
+        }
+        catch (const task_deleted &)
+        {
+        }
+    });
+
+    if (created_task)
+    {
+        *created_task = task;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == nullptr || task == current_task)
+    {
+        current_task->deleted = true;
+        current_task->thread.detach();
+        throw task_deleted{};
+    }
+
+    {
+        std::lock_guard guard(lock);
+        task->deleted = true;
+    }
+    changed.notify_all();
+    task->thread.join();
+    delete task;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    std::unique_lock guard(lock);
+    wait(guard, ticks, [] { return false; });
+}
+
+BaseType_t xPortGetCoreID()
+{
+    return 0;
+}
+
+void vPortEnterCritical(portMUX_TYPE *mux)
+{
+    while (mux->locked.test_and_set(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+}
+
+void vPortExitCritical(portMUX_TYPE *mux)
+{
+    mux->locked.clear(std::memory_order_release);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    {
+        std::lock_guard guard(lock);
+        task->notifications++;
+    }
+    changed.notify_all();
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait)
+{
+    std::unique_lock guard(lock);
+    wait(guard, ticks_to_wait, [] { return current_task->notifications > 0; });
+    const auto count = current_task->notifications;
+    if (count)
+    {
+        current_task->notifications = clear_count_on_exit ? 0 : count - 1;
+    }
+    return count;
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t *storage, StaticQueue_t *queue)
+{
+    *queue = StaticQueue_t{.storage = storage, .length = length, .item_size = item_size, .head = 0, .count = 0};
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t)
+{
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    std::unique_lock guard(lock);
+    if (!wait(guard, ticks_to_wait, [queue] { return queue->count < queue->length; }))
+    {
+        return pdFALSE;
+    }
+
+    const auto tail = (queue->head + queue->count) % queue->length;
+    memcpy(queue->storage + tail * queue->item_size, item, queue->item_size);
+    queue->count++;
+    changed.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    std::unique_lock guard(lock);
+    if (!wait(guard, ticks_to_wait, [queue] { return queue->count > 0; }))
+    {
+        return pdFALSE;
+    }
+
+    memcpy(item, queue->storage + queue->head * queue->item_size, queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    changed.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    std::unique_lock guard(lock);
+    if (!wait(guard, ticks_to_wait, [queue] { return queue->count > 0; }))
+    {
+        return pdFALSE;
+    }
+
+    memcpy(item, queue->storage + queue->head * queue->item_size, queue->item_size);
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    std::lock_guard guard(lock);
+    return queue->count;
+}
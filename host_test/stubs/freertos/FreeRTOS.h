@@ -0,0 +1,33 @@
+#pragma once
+
+// Host stand-in for the parts of FreeRTOS used by main/util. Tasks are threads, a tick is a millisecond.
+
+#include "sdkconfig.h"
+#include <assert.h>
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+
+#define portMAX_DELAY (TickType_t)0xffffffffUL
+#define configTICK_RATE_HZ 1000
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+#define configASSERT(x) assert(x)
+
+// a spinlock between cores on the ESP32, here a spinlock between threads
+typedef struct
+{
+    std::atomic_flag locked;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {}
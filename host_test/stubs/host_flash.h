@@ -0,0 +1,51 @@
+#pragma once
+
+// Control over the in-memory update partition behind the esp_ota_ops.h and esp_partition.h stand-ins.
+
+#include "esp_ota_ops.h"
+#include <chrono>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace host_flash
+{
+/**
+ * Erases the partition and forgets the boot partition and all simulated faults.
+ */
+void reset();
+
+/**
+ * The bytes written by esp_ota_write since the last esp_ota_begin.
+ */
+std::vector<uint8_t> written_image();
+
+bool is_boot_partition_set();
+
+/**
+ * Makes every esp_ota_write take at least this long, like a flash erase and program would.
+ */
+void set_write_delay(std::chrono::microseconds delay);
+
+/**
+ * While held, esp_ota_write waits, like flash that is busy for as long as the test wants.
+ */
+void hold_writes(bool hold);
+
+/**
+ * Lets esp_ota_write fail once this many bytes are written.
+ */
+void fail_writes_after(size_t bytes);
+
+/**
+ * Sets the state of the running image, as the bootloader leaves it after an update.
+ */
+void set_running_image_state(esp_ota_img_states_t state);
+
+esp_ota_img_states_t running_image_state();
+
+/**
+ * Flips the bits of one byte in the partition, as a failed program operation would leave it.
+ */
+void corrupt(size_t offset);
+} // namespace host_flash
@@ -0,0 +1,130 @@
+#include "mbedtls/md.h"
+#include "mbedtls/sha256.h"
+
+#include <openssl/evp.h>
+
+// what mbedtls returns for a bad argument to the md layer
+constexpr int MBEDTLS_ERR_MD_BAD_INPUT_DATA = -0x5100;
+
+struct mbedtls_md_info_t
+{
+    const EVP_MD *(*evp)();
+};
+
+namespace
+{
+const mbedtls_md_info_t md5_info{EVP_md5};
+const mbedtls_md_info_t sha1_info{EVP_sha1};
+const mbedtls_md_info_t sha224_info{EVP_sha224};
+const mbedtls_md_info_t sha256_info{EVP_sha256};
+const mbedtls_md_info_t sha384_info{EVP_sha384};
+const mbedtls_md_info_t sha512_info{EVP_sha512};
+
+int result(int openssl_ret)
+{
+    return openssl_ret == 1 ? 0 : MBEDTLS_ERR_MD_BAD_INPUT_DATA;
+}
+
+EVP_MD_CTX *evp_context(void *ctx)
+{
+    return static_cast<EVP_MD_CTX *>(ctx);
+}
+} // namespace
+
+const mbedtls_md_info_t *mbedtls_md_info_from_type(mbedtls_md_type_t md_type)
+{
+    switch (md_type)
+    {
+    case MBEDTLS_MD_MD5:
+        return &md5_info;
+    case MBEDTLS_MD_SHA1:
+        return &sha1_info;
+    case MBEDTLS_MD_SHA224:
+        return &sha224_info;
+    case MBEDTLS_MD_SHA256:
+        return &sha256_info;
+    case MBEDTLS_MD_SHA384:
+        return &sha384_info;
+    case MBEDTLS_MD_SHA512:
+        return &sha512_info;
+    default:
+        return nullptr;
+    }
+}
+
+void mbedtls_md_init(mbedtls_md_context_t *ctx)
+{
+    *ctx = {};
+}
+
+void mbedtls_md_free(mbedtls_md_context_t *ctx)
+{
+    EVP_MD_CTX_free(evp_context(ctx->md_ctx));
+    *ctx = {};
+}
+
+int mbedtls_md_setup(mbedtls_md_context_t *ctx, const mbedtls_md_info_t *md_info, int hmac)
+{
+    if (md_info == nullptr || hmac)
+    {
+        return MBEDTLS_ERR_MD_BAD_INPUT_DATA;
+    }
+    ctx->md_info = md_info;
+    ctx->md_ctx = EVP_MD_CTX_new();
+    return ctx->md_ctx ? 0 : MBEDTLS_ERR_MD_BAD_INPUT_DATA;
+}
+
+int mbedtls_md_starts(mbedtls_md_context_t *ctx)
+{
+    return result(EVP_DigestInit_ex(evp_context(ctx->md_ctx), ctx->md_info->evp(), nullptr));
+}
+
+int mbedtls_md_update(mbedtls_md_context_t *ctx, const unsigned char *input, size_t ilen)
+{
+    return result(EVP_DigestUpdate(evp_context(ctx->md_ctx), input, ilen));
+}
+
+int mbedtls_md_finish(mbedtls_md_context_t *ctx, unsigned char *output)
+{
+    return result(EVP_DigestFinal_ex(evp_context(ctx->md_ctx), output, nullptr));
+}
+
+int mbedtls_md(const mbedtls_md_info_t *md_info, const unsigned char *input, size_t ilen, unsigned char *output)
+{
+    if (md_info == nullptr)
+    {
+        return MBEDTLS_ERR_MD_BAD_INPUT_DATA;
+    }
+    return result(EVP_Digest(input, ilen, output, nullptr, md_info->evp(), nullptr));
+}
+
+void mbedtls_sha256_init(mbedtls_sha256_context *ctx)
+{
+    ctx->ctx = EVP_MD_CTX_new();
+}
+
+void mbedtls_sha256_free(mbedtls_sha256_context *ctx)
+{
+    EVP_MD_CTX_free(evp_context(ctx->ctx));
+    ctx->ctx = nullptr;
+}
+
+int mbedtls_sha256_starts(mbedtls_sha256_context *ctx, int is224)
+{
+    return result(EVP_DigestInit_ex(evp_context(ctx->ctx), is224 ? EVP_sha224() : EVP_sha256(), nullptr));
+}
+
+int mbedtls_sha256_update(mbedtls_sha256_context *ctx, const unsigned char *input, size_t ilen)
+{
+    return result(EVP_DigestUpdate(evp_context(ctx->ctx), input, ilen));
+}
+
+int mbedtls_sha256_finish(mbedtls_sha256_context *ctx, unsigned char *output)
+{
+    return result(EVP_DigestFinal_ex(evp_context(ctx->ctx), output, nullptr));
+}
+
+int mbedtls_sha256(const unsigned char *input, size_t ilen, unsigned char *output, int is224)
+{
+    return result(EVP_Digest(input, ilen, output, nullptr, is224 ? EVP_sha224() : EVP_sha256(), nullptr));
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+// Host stand-in for the mbedtls SHA-256 API, implemented with OpenSSL in mbedtls.cpp.
+
+#include <stddef.h>
+
+typedef struct mbedtls_sha256_context
+{
+    void *ctx;
+} mbedtls_sha256_context;
+
+void mbedtls_sha256_init(mbedtls_sha256_context *ctx);
+void mbedtls_sha256_free(mbedtls_sha256_context *ctx);
+int mbedtls_sha256_starts(mbedtls_sha256_context *ctx, int is224);
+int mbedtls_sha256_update(mbedtls_sha256_context *ctx, const unsigned char *input, size_t ilen);
+int mbedtls_sha256_finish(mbedtls_sha256_context *ctx, unsigned char *output);
+int mbedtls_sha256(const unsigned char *input, size_t ilen, unsigned char *output, int is224);
@@ -0,0 +1,5 @@
+#pragma once
+
+// Host stand-in for the generated sdkconfig.h, only the options main/ reads.
+
+#define CONFIG_ESP_MAIN_TASK_AFFINITY_CPU0 1
@@ -0,0 +1,299 @@
+#include "display_renderer.h"
+#include "hardware/display/feedback_decoder.h"
+#include "hardware/uart/avr_state_parser.h"
+#include "hardware/uart/command_processor.h"
+#include "util/event_bus.h"
+#include "util/timer/timer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <new>
+#include <thread>
+
+extern "C" void *__real_malloc(size_t size);
+extern "C" void *__real_calloc(size_t count, size_t size);
+extern "C" void *__real_realloc(void *pointer, size_t size);
+
+// every heap allocation of the test binary is counted: operator new is replaced below, malloc, calloc
+// and realloc are wrapped by the linker (see CMakeLists.txt)
+namespace
+{
+std::atomic<size_t> allocations{0};
+
+void *allocate(size_t size)
+{
+    allocations++;
+    return __real_malloc(size ? size : 1);
+}
+
+void *allocate_aligned(size_t size, std::align_val_t alignment)
+{
+    allocations++;
+    const auto align = static_cast<size_t>(alignment);
+    return std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) / align * align);
+}
+
+/**
+ * Counts the allocations made, by any thread, while it is alive.
+ */
+class allocation_counter
+{
+  public:
+    allocation_counter() : start_(allocations.load())
+    {
+    }
+
+    size_t count() const
+    {
+        return allocations.load() - start_;
+    }
+
+  private:
+    size_t start_;
+};
+} // namespace
+
+extern "C"
+{
+
+void *__wrap_malloc(size_t size)
+{
+    allocations++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    allocations++;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size)
+{
+    allocations++;
+    return __real_realloc(pointer, size);
+}
+}
+
+void *operator new(size_t size)
+{
+    if (auto pointer = allocate(size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    if (auto pointer = allocate_aligned(size, alignment))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace
+{
+using namespace std::chrono_literals;
+
+void count_expiry(void *arg)
+{
+    static_cast<std::atomic<int> *>(arg)->fetch_add(1);
+}
+
+bool wait_for(const std::atomic<int> &value, int expected)
+{
+    const auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (value < expected)
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+} // namespace
+
+TEST(allocations, counter_sees_new_and_malloc)
+{
+    allocation_counter counter;
+    // volatile, so the compiler can not leave the allocations out
+    int *volatile number = new int(1);
+    delete number;
+    void *volatile block = std::malloc(16);
+    std::free(block);
+    EXPECT_EQ(counter.count(), 2u);
+}
+
+TEST(allocations, timer_start_stop_restart)
+{
+    std::atomic<int> expired{0};
+    esp32::timer::timer timer(count_expiry, &expired, "test");
+
+    allocation_counter counter;
+    for (int i = 0; i < 1000; i++)
+    {
+        timer.start_one_shot(1h);
+        timer.restart(2h);
+        timer.restart_one_shot(1h);
+        EXPECT_TRUE(timer.is_active());
+        timer.stop();
+        timer.stop_if_active();
+        EXPECT_FALSE(timer.restart_if_active(1h));
+        timer.restart_one_shot(1h);
+        timer.stop_if_active();
+
+        timer.start_periodic(1h);
+        EXPECT_TRUE(timer.restart_if_active(2h));
+        timer.stop_if_active();
+    }
+    EXPECT_EQ(counter.count(), 0u);
+    EXPECT_EQ(expired, 0);
+}
+
+TEST(allocations, timer_expiry_and_restart_after_it)
+{
+    std::atomic<int> expired{0};
+    esp32::timer::timer timer(count_expiry, &expired, "test");
+
+    allocation_counter counter;
+    timer.start_one_shot(1ms);
+    ASSERT_TRUE(wait_for(expired, 1));
+    EXPECT_FALSE(timer.is_active());
+
+    // the one-shot timer expired, so it is started again
+    timer.restart_one_shot(1ms);
+    ASSERT_TRUE(wait_for(expired, 2));
+
+    timer.start_periodic(1ms);
+    ASSERT_TRUE(wait_for(expired, 5));
+    timer.stop_if_active();
+    EXPECT_EQ(counter.count(), 0u);
+}
+
+TEST(allocations, display_state_changes)
+{
+    // one frame of every display state, the volumes on both sides of the scale
+    constexpr std::array<std::string_view, 12> frames{
+        "PWON",         "PWSTANDBY", "MV455", "MV00",          "MV98", "MVMAX 80", "MUON",
+        "PSDYNVOL MED", "SIBD",      "SITV",  "MSDOLBY ATMOS", "MUOFF",
+    };
+    std::string stream;
+    for (auto &&frame : frames)
+    {
+        stream.append(frame).push_back('\r');
+    }
+    command_processor processor;
+    display_renderer with_bar;
+    display_renderer with_digits(false);
+
+    allocation_counter counter;
+    size_t states = 0;
+    size_t lit_columns = 0;
+    for (int i = 0; i < 100; i++)
+    {
+        processor.add_data(stream);
+        command_processor::frame frame;
+        while (processor.pop_command(frame))
+        {
+            const auto delta = avr_state_parser::parse(frame.view());
+            const auto value = delta.has_value() ? feedback_decoder::decode(*delta) : std::nullopt;
+            if (value.has_value())
+            {
+                states++;
+                lit_columns += std::ranges::count_if(with_bar.render(*value).to_module_rows(), [](auto row) { return row != 0; });
+                lit_columns += with_digits.render(*value).column(0) != 0;
+                for (size_t offset = 0; offset < 40; offset++)
+                {
+                    lit_columns += with_bar.scroll_text(offset).column(0) != 0;
+                }
+            }
+        }
+    }
+    EXPECT_EQ(counter.count(), 0u);
+    EXPECT_GT(states, 0u);
+    EXPECT_GT(lit_columns, 0u);
+}
+
+TEST(allocations, event_bus_post_and_dispatch)
+{
+    using bus = esp32::event_bus<2, sizeof(avr_state_update)>;
+    ASSERT_EQ(bus::instance().begin(4096, 5, 0), ESP_OK);
+    std::atomic<int> handled{0};
+    esp32::event_subscriber_typed<bus, avr_state_update> subscriber(
+        1, [](void *context, int32_t, const avr_state_update &) { static_cast<std::atomic<int> *>(context)->fetch_add(1); }, &handled);
+    subscriber.subscribe();
+
+    allocation_counter counter;
+    int posted = 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        posted += bus::instance().post(1, avr_state_update{}, bus::lane::priority) == ESP_OK;
+    }
+    ASSERT_TRUE(wait_for(handled, posted));
+    EXPECT_EQ(counter.count(), 0u);
+}
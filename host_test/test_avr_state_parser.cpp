@@ -0,0 +1,66 @@
+#include "hardware/uart/avr_state_parser.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+template <typename T> T parse_as(std::string_view frame)
+{
+    const auto delta = avr_state_parser::parse(frame);
+    EXPECT_TRUE(delta.has_value()) << frame;
+    EXPECT_TRUE(delta.has_value() && std::holds_alternative<T>(*delta)) << frame;
+    return delta.has_value() && std::holds_alternative<T>(*delta) ? std::get<T>(*delta) : T{};
+}
+} // namespace
+
+TEST(avr_state_parser, power)
+{
+    EXPECT_EQ(parse_as<avr_state::power_t>("PWON"), avr_state::power_t::on);
+    EXPECT_EQ(parse_as<avr_state::power_t>("PWSTANDBY"), avr_state::power_t::standby);
+    EXPECT_FALSE(avr_state_parser::parse("PWOFF").has_value());
+}
+
+TEST(avr_state_parser, mute)
+{
+    EXPECT_TRUE(parse_as<avr_state::mute_t>("MUON").on);
+    EXPECT_FALSE(parse_as<avr_state::mute_t>("MUOFF").on);
+}
+
+TEST(avr_state_parser, volume_in_half_db)
+{
+    EXPECT_EQ(parse_as<avr_state::volume_t>("MV45").half_db, 90);
+    EXPECT_EQ(parse_as<avr_state::volume_t>("MV455").half_db, 91);
+    EXPECT_EQ(parse_as<avr_state::volume_t>("MV00").half_db, 0);
+    EXPECT_FALSE(avr_state_parser::parse("MV").has_value());
+    EXPECT_FALSE(avr_state_parser::parse("MV4").has_value());
+    EXPECT_FALSE(avr_state_parser::parse("MV4A").has_value());
+}
+
+TEST(avr_state_parser, max_volume_wins_over_volume)
+{
+    EXPECT_EQ(parse_as<avr_state::max_volume_t>("MVMAX 98").half_db, 196);
+    EXPECT_EQ(parse_as<avr_state::max_volume_t>("MVMAX 985").half_db, 197);
+}
+
+TEST(avr_state_parser, dynamic_volume)
+{
+    EXPECT_EQ(parse_as<avr_state::dynamic_volume_t>("PSDYNVOL OFF"), avr_state::dynamic_volume_t::off);
+    EXPECT_EQ(parse_as<avr_state::dynamic_volume_t>("PSDYNVOL LIT"), avr_state::dynamic_volume_t::light);
+    EXPECT_EQ(parse_as<avr_state::dynamic_volume_t>("PSDYNVOL MED"), avr_state::dynamic_volume_t::medium);
+    EXPECT_EQ(parse_as<avr_state::dynamic_volume_t>("PSDYNVOL HEV"), avr_state::dynamic_volume_t::heavy);
+    EXPECT_FALSE(avr_state_parser::parse("PSDYNVOL").has_value());
+}
+
+TEST(avr_state_parser, names)
+{
+    EXPECT_EQ(parse_as<avr_state::input_source_t>("SIBD").name.view(), "BD");
+    EXPECT_EQ(parse_as<avr_state::surround_mode_t>("MSDOLBY DIGITAL").name.view(), "DOLBY DIGITAL");
+    EXPECT_FALSE(avr_state_parser::parse("SI").has_value());
+}
+
+TEST(avr_state_parser, unknown_frames)
+{
+    EXPECT_FALSE(avr_state_parser::parse("").has_value());
+    EXPECT_FALSE(avr_state_parser::parse("M").has_value());
+    EXPECT_FALSE(avr_state_parser::parse("ZMON").has_value());
+    EXPECT_FALSE(avr_state_parser::parse("CVFL 50").has_value());
+}
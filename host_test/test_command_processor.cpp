@@ -0,0 +1,74 @@
+#include "hardware/uart/command_processor.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::vector<std::string> pop_all(command_processor &processor)
+{
+    std::vector<std::string> frames;
+    command_processor::frame frame;
+    while (processor.pop_command(frame))
+    {
+        frames.emplace_back(frame.view());
+    }
+    return frames;
+}
+} // namespace
+
+TEST(command_processor, splits_on_cr)
+{
+    command_processor processor;
+    EXPECT_EQ(processor.add_data("PWON\rMV455\rMUOFF\r"), 3);
+    EXPECT_EQ(pop_all(processor), (std::vector<std::string>{"PWON", "MV455", "MUOFF"}));
+}
+
+TEST(command_processor, joins_frames_split_across_reads)
+{
+    command_processor processor;
+    EXPECT_EQ(processor.add_data("PW"), 0);
+    EXPECT_EQ(processor.add_data("ON\rMV"), 1);
+    EXPECT_EQ(processor.add_data("45\r"), 1);
+    EXPECT_EQ(pop_all(processor), (std::vector<std::string>{"PWON", "MV45"}));
+}
+
+TEST(command_processor, drops_frames_when_consumer_falls_behind)
+{
+    command_processor processor;
+    std::string data;
+    for (size_t i = 0; i < command_processor::max_pending_frames + 3; i++)
+    {
+        data += "MV45\r";
+    }
+    processor.add_data(data);
+
+    EXPECT_EQ(pop_all(processor).size(), command_processor::max_pending_frames);
+    EXPECT_EQ(processor.get_loss_stats().frames_dropped, 3);
+    EXPECT_EQ(processor.get_loss_stats().bytes_dropped, 12);
+}
+
+TEST(command_processor, drops_overlong_frames_up_to_next_cr)
+{
+    command_processor processor;
+    processor.add_data(std::string(MAX_COMMAND_SIZE + 1, 'X'));
+    processor.add_data("YY\rPWON\r");
+
+    EXPECT_EQ(pop_all(processor), (std::vector<std::string>{"PWON"}));
+    EXPECT_EQ(processor.get_loss_stats().frames_dropped, 1);
+    EXPECT_EQ(processor.get_loss_stats().bytes_dropped, MAX_COMMAND_SIZE + 3);
+}
+
+TEST(command_processor, resync_discards_torn_frame)
+{
+    command_processor processor;
+    processor.add_data("PWON\rMV4");
+    processor.resync();
+    processor.add_data("5\rMUON\r");
+
+    EXPECT_EQ(pop_all(processor), (std::vector<std::string>{"PWON", "MUON"}));
+    const auto stats = processor.get_loss_stats();
+    EXPECT_EQ(stats.overflow_events, 1);
+    EXPECT_EQ(stats.frames_dropped, 1);
+    EXPECT_EQ(stats.bytes_dropped, 4);
+}
@@ -0,0 +1,65 @@
+#include "hardware/uart/command_scheduler.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+std::vector<std::string> send_due(command_scheduler &scheduler, command_scheduler::time_point now)
+{
+    std::vector<std::string> sent;
+    while (auto command = scheduler.next_command(now))
+    {
+        sent.emplace_back(*command);
+    }
+    return sent;
+}
+} // namespace
+
+TEST(command_scheduler, spaces_queries)
+{
+    command_scheduler scheduler;
+    scheduler.request_all();
+
+    EXPECT_EQ(send_due(scheduler, 0us), (std::vector<std::string>{"PW?"}));
+    EXPECT_TRUE(send_due(scheduler, 10ms).empty());
+    EXPECT_EQ(send_due(scheduler, 50ms), (std::vector<std::string>{"MV?"}));
+    ASSERT_TRUE(scheduler.next_deadline().has_value());
+    EXPECT_EQ(*scheduler.next_deadline(), 100ms);
+}
+
+TEST(command_scheduler, answered_queries_are_not_repeated)
+{
+    command_scheduler scheduler;
+    scheduler.request_all();
+
+    std::vector<std::string> sent;
+    for (auto now = 0ms; now < 2s; now += 10ms)
+    {
+        for (auto &&command : send_due(scheduler, now))
+        {
+            sent.push_back(command);
+            // answer everything right away
+            scheduler.on_frame(command.substr(0, command.find_first_of(" ?")));
+        }
+    }
+    EXPECT_EQ(sent.size(), command_scheduler::status_queries.size());
+    EXPECT_FALSE(scheduler.next_deadline().has_value());
+    EXPECT_TRUE(scheduler.is_connected());
+}
+
+TEST(command_scheduler, silence_means_disconnected)
+{
+    command_scheduler scheduler;
+    scheduler.request_all();
+    for (auto now = 0ms; now < 3s; now += 10ms)
+    {
+        send_due(scheduler, now);
+    }
+    EXPECT_FALSE(scheduler.is_connected());
+
+    scheduler.on_frame("PWON");
+    EXPECT_TRUE(scheduler.is_connected());
+}
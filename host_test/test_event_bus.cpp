@@ -0,0 +1,110 @@
+#include "util/event_bus.h"
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+enum test_event : int32_t
+{
+    plain,
+    with_payload,
+    test_event_count,
+};
+
+typedef struct payload
+{
+    uint32_t sequence;
+    uint8_t value;
+} payload;
+
+using test_bus = esp32::event_bus<test_event_count, sizeof(payload)>;
+
+// records what the subscribers see, the dispatch task writes and the test thread reads
+struct recorder
+{
+    std::mutex lock;
+    std::vector<int32_t> events;
+    std::vector<payload> payloads;
+
+    static void on_event(void *context, int32_t event_id)
+    {
+        auto p_this = static_cast<recorder *>(context);
+        std::lock_guard guard(p_this->lock);
+        p_this->events.push_back(event_id);
+    }
+
+    static void on_payload(void *context, int32_t, const payload &value)
+    {
+        auto p_this = static_cast<recorder *>(context);
+        std::lock_guard guard(p_this->lock);
+        p_this->payloads.push_back(value);
+    }
+
+    bool wait_for_events(size_t count)
+    {
+        for (int i = 0; i < 2000; i++)
+        {
+            {
+                std::lock_guard guard(lock);
+                if (events.size() >= count)
+                {
+                    return true;
+                }
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return false;
+    }
+};
+
+test_bus &started_bus()
+{
+    static const auto started = test_bus::instance().begin(4096, 5, 0);
+    EXPECT_EQ(started, ESP_OK);
+    return test_bus::instance();
+}
+} // namespace
+
+TEST(event_bus, typed_subscribers_get_their_events)
+{
+    auto &bus = started_bus();
+    recorder record;
+    esp32::event_subscriber_typed<test_bus, void> any(test_bus::any_event, recorder::on_event, &record);
+    esp32::event_subscriber_typed<test_bus, payload> typed(with_payload, recorder::on_payload, &record);
+    any.subscribe();
+    typed.subscribe();
+
+    EXPECT_EQ(bus.post(plain), ESP_OK);
+    EXPECT_EQ(bus.post(with_payload, payload{7, 42}), ESP_OK);
+    ASSERT_TRUE(record.wait_for_events(2));
+
+    std::lock_guard guard(record.lock);
+    EXPECT_EQ(record.events, (std::vector<int32_t>{plain, with_payload}));
+    ASSERT_EQ(record.payloads.size(), 1u);
+    EXPECT_EQ(record.payloads[0].sequence, 7u);
+    EXPECT_EQ(record.payloads[0].value, 42);
+}
+
+TEST(event_bus, unsubscribed_when_destroyed)
+{
+    auto &bus = started_bus();
+    recorder record;
+    // more subscribers than the table holds, each one frees its slot again
+    for (int i = 0; i < 8; i++)
+    {
+        esp32::event_subscriber_typed<test_bus, void> temporary(plain, recorder::on_event, &record);
+        temporary.subscribe();
+    }
+    esp32::event_subscriber_typed<test_bus, void> last(plain, recorder::on_event, &record);
+    last.subscribe();
+
+    EXPECT_EQ(bus.post(plain), ESP_OK);
+    EXPECT_TRUE(record.wait_for_events(1));
+    std::this_thread::sleep_for(10ms);
+    std::lock_guard guard(record.lock);
+    EXPECT_EQ(record.events.size(), 1u);
+}
@@ -0,0 +1,45 @@
+#include "hardware/display/feedback_decoder.h"
+#include <gtest/gtest.h>
+
+using namespace display_state;
+
+TEST(feedback_decoder, power)
+{
+    const auto off = feedback_decoder::decode(avr_state::power_t::standby);
+    ASSERT_TRUE(off.has_value());
+    EXPECT_TRUE(std::holds_alternative<PowerOff>(*off));
+
+    const auto on = feedback_decoder::decode(avr_state::power_t::on);
+    ASSERT_TRUE(on.has_value());
+    ASSERT_TRUE(std::holds_alternative<FourChars>(*on));
+    EXPECT_EQ(std::get<FourChars>(*on).value, (std::array<uint8_t, 4>{' ', 'O', 'N', ' '}));
+}
+
+TEST(feedback_decoder, mute)
+{
+    EXPECT_TRUE(std::holds_alternative<MuteOn>(*feedback_decoder::decode(avr_state::mute_t{true})));
+    EXPECT_TRUE(std::holds_alternative<None>(*feedback_decoder::decode(avr_state::mute_t{false})));
+}
+
+TEST(feedback_decoder, volume_and_dynamic_volume)
+{
+    const auto volume = feedback_decoder::decode(avr_state::volume_t{91});
+    ASSERT_TRUE(volume.has_value() && std::holds_alternative<Volume>(*volume));
+    EXPECT_EQ(std::get<Volume>(*volume).half_db, 91);
+
+    const auto dynamic_volume = feedback_decoder::decode(avr_state::dynamic_volume_t::medium);
+    ASSERT_TRUE(dynamic_volume.has_value() && std::holds_alternative<DynVol>(*dynamic_volume));
+    EXPECT_EQ(std::get<DynVol>(*dynamic_volume).value, 2);
+}
+
+TEST(feedback_decoder, names_become_text)
+{
+    const auto source = feedback_decoder::decode(avr_state::input_source_t{fixed_string<16>::from("TUNER")});
+    ASSERT_TRUE(source.has_value() && std::holds_alternative<Text>(*source));
+    EXPECT_EQ(std::get<Text>(*source).value.view(), "TUNER");
+}
+
+TEST(feedback_decoder, max_volume_is_not_shown)
+{
+    EXPECT_FALSE(feedback_decoder::decode(avr_state::max_volume_t{196}).has_value());
+}
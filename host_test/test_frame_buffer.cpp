@@ -0,0 +1,255 @@
+#include "display_renderer.h"
+#include "hardware/display/compositor.h"
+#include "hardware/display/frame_buffer.h"
+#include "hardware/display/screens.h"
+#include "hardware/display/text_renderer.h"
+#include "hardware/display/volume_bar.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+
+namespace
+{
+// images are given like to_ascii prints them, '#' lit and '.' dark, one line per row
+frame_buffer from_ascii(std::string_view image)
+{
+    frame_buffer frame;
+    for (size_t y = 0; y < frame_buffer::height; y++)
+    {
+        for (size_t x = 0; x < frame_buffer::width; x++)
+        {
+            if (image[y * (frame_buffer::width + 1) + x] == '#')
+            {
+                frame.set_column(x, frame.column(x) | (1 << y));
+            }
+        }
+    }
+    return frame;
+}
+
+// failures print the whole image, which shows where it differs
+std::string ascii(const frame_buffer &frame)
+{
+    return frame.to_ascii().data();
+}
+
+constexpr std::string_view corner_image = "##..............................\n"
+                                          "#...............................\n"
+                                          "................................\n"
+                                          "................................\n"
+                                          "................................\n"
+                                          "................................\n"
+                                          "................................\n"
+                                          "...............................#\n";
+} // namespace
+
+TEST(frame_buffer, ascii_round_trip)
+{
+    const auto frame = from_ascii(corner_image);
+    EXPECT_EQ(std::string_view(frame.to_ascii().data()), corner_image);
+}
+
+TEST(frame_buffer, module_rows_round_trip)
+{
+    const auto frame = from_ascii(corner_image);
+    const auto rows = frame.to_module_rows();
+    // row 0 of the first module has its two leftmost pixels lit
+    EXPECT_EQ(rows[0] & 0xff, 0x03);
+    EXPECT_EQ(frame_buffer::from_module_rows(rows), frame);
+}
+
+TEST(frame_buffer, shift_columns_across_modules)
+{
+    auto frame = from_ascii(corner_image);
+    frame.shift_columns(9);
+    EXPECT_EQ(frame.column(9), 0x03);
+    EXPECT_EQ(frame.column(10), 0x01);
+    EXPECT_EQ(frame.column(31), 0x00);
+
+    frame.shift_columns(-9);
+    EXPECT_EQ(frame.column(0), 0x03);
+
+    frame.shift_columns(32);
+    EXPECT_EQ(frame, frame_buffer{});
+}
+
+TEST(frame_buffer, shift_rows_drops_pixels_at_the_edge)
+{
+    auto frame = from_ascii(corner_image);
+    frame.shift_rows(1);
+    EXPECT_EQ(frame.column(0), 0x06);
+    EXPECT_EQ(frame.column(31), 0x00);
+}
+
+TEST(frame_buffer, mirror_and_flip)
+{
+    auto frame = from_ascii(corner_image);
+    frame.mirror();
+    EXPECT_EQ(frame.column(31), 0x03);
+    EXPECT_EQ(frame.column(0), 0x80);
+    frame.flip();
+    EXPECT_EQ(frame.column(31), 0xc0);
+    EXPECT_EQ(frame.column(0), 0x01);
+}
+
+TEST(compositor, overlay_replaces_masked_columns)
+{
+    compositor layers;
+    layers.set(compositor::layer_id::base, screens::all_on);
+    layers.set(compositor::layer_id::overlay, frame_buffer{}, blend_op::replace, 0x0000000f);
+    const auto frame = layers.compose();
+    EXPECT_EQ(frame.column(0), 0x00);
+    EXPECT_EQ(frame.column(3), 0x00);
+    EXPECT_EQ(frame.column(4), 0xff);
+}
+
+TEST(volume_bar, full_scale)
+{
+    volume_bar bar;
+    bar.set_max(100);
+    EXPECT_EQ(bar.position(0), 0);
+    EXPECT_EQ(bar.position(100), volume_bar::full_position);
+    EXPECT_EQ(bar.position(150), volume_bar::full_position);
+    EXPECT_EQ(volume_bar::frame(volume_bar::full_position), screens::all_on);
+}
+
+TEST(text_renderer, width_matches_render)
+{
+    std::array<uint8_t, 64> columns{};
+    const auto used = text_renderer::render("CD", columns);
+    EXPECT_EQ(used, text_renderer::width("CD"));
+    EXPECT_GT(used, 0);
+    EXPECT_EQ(text_renderer::width("CD  "), used);
+}
+
+TEST(screens, mute_on)
+{
+    constexpr std::string_view expected = "##...##..........##...........##\n"
+                                          "###.###..........##...........##\n"
+                                          "#######..........##...........##\n"
+                                          "##.#.##.##..##.######.####....##\n"
+                                          "##...##.##..##...##...#..#.#####\n"
+                                          "##...##.##..##...##...####.#..##\n"
+                                          "##...##.##..##...##...#....#..##\n"
+                                          "##...##.######...##...####.#####\n";
+    EXPECT_EQ(ascii(display_renderer().render(display_state::MuteOn{})), expected);
+}
+
+TEST(screens, power_off)
+{
+    constexpr std::string_view expected = "......####...######..######.....\n"
+                                          ".....##..##..##......##.........\n"
+                                          ".....##..##..##......##.........\n"
+                                          ".....##..##..#####...#####......\n"
+                                          ".....##..##..#####...#####......\n"
+                                          ".....##..##..##......##.........\n"
+                                          ".....##..##..##......##.........\n"
+                                          "......####...##......##.........\n";
+    EXPECT_EQ(ascii(display_renderer().render(display_state::PowerOff{})), expected);
+}
+
+TEST(screens, dyn_vol_level_over_label)
+{
+    constexpr std::string_view expected = "###..........#..#.....#.........\n"
+                                          "#..#.........#..#.....#....##...\n"
+                                          "#..#.........#..#.....#...####..\n"
+                                          "#..#.#.#.###.#..#.....#..######.\n"
+                                          "#..#.#.#.#.#.#..#.###.#.########\n"
+                                          "#..#.###.#.#.#..#.#.#.#...####..\n"
+                                          "#..#...#.#.#..###.#.#.#...####..\n"
+                                          "###..###.#.#..##..###.#...####..\n";
+    EXPECT_EQ(ascii(display_renderer().render(display_state::DynVol{2})), expected);
+}
+
+TEST(screens, dyn_vol_off)
+{
+    constexpr std::string_view expected = "###..........#..#.....#...####..\n"
+                                          "#..#.........#..#.....#..#....#.\n"
+                                          "#..#.........#..#.....#.#....#.#\n"
+                                          "#..#.#.#.###.#..#.....#.#...#..#\n"
+                                          "#..#.#.#.#.#.#..#.###.#.#..#...#\n"
+                                          "#..#.###.#.#.#..#.#.#.#.#.#....#\n"
+                                          "#..#...#.#.#..###.#.#.#..#....#.\n"
+                                          "###..###.#.#..##..###.#...####..\n";
+    EXPECT_EQ(ascii(display_renderer().render(display_state::DynVol{0})), expected);
+}
+
+TEST(screens, four_chars)
+{
+    constexpr std::string_view expected = ".#####...#####..................\n"
+                                          ".##..##..##..##.................\n"
+                                          ".##..##..##..##.................\n"
+                                          ".#####...##..##.................\n"
+                                          ".#####...##..##.................\n"
+                                          ".##..##..##..##.................\n"
+                                          ".##..##..##..##.................\n"
+                                          ".#####...#####..................\n";
+    EXPECT_EQ(ascii(display_renderer().render(display_state::FourChars{{'B', 'D', ' ', ' '}})), expected);
+}
+
+TEST(screens, volume_digits_with_half_db)
+{
+    constexpr std::string_view expected = ".........##.##...######.........\n"
+                                          ".........##.##...##..##....##...\n"
+                                          ".........##.##...##........##...\n"
+                                          ".........##.##...#####...######.\n"
+                                          ".........######......##..######.\n"
+                                          "............##...##..##....##...\n"
+                                          "............##...##..##....##...\n"
+                                          "............##....####..........\n";
+    EXPECT_EQ(ascii(display_renderer(false).render(display_state::Volume{91})), expected);
+}
+
+TEST(screens, volume_bar_with_partial_column)
+{
+    constexpr std::string_view expected = "##############..................\n"
+                                          "##############..................\n"
+                                          "###############.................\n"
+                                          "###############.................\n"
+                                          "###############.................\n"
+                                          "###############.................\n"
+                                          "###############.................\n"
+                                          "###############.................\n";
+    EXPECT_EQ(ascii(display_renderer().render(display_state::Volume{91})), expected);
+}
+
+TEST(screens, short_text_centered)
+{
+    constexpr std::string_view expected = "..........####..#####...........\n"
+                                          ".........##..##.##..##..........\n"
+                                          ".........##.....##..##..........\n"
+                                          ".........##.....##..##..........\n"
+                                          ".........##.....##..##..........\n"
+                                          ".........##.....##..##..........\n"
+                                          ".........##..##.##..##..........\n"
+                                          "..........####..#####...........\n";
+    EXPECT_EQ(ascii(display_renderer().render(display_state::Text{fixed_string<24>::from("CD")})), expected);
+}
+
+TEST(screens, long_text_starts_left)
+{
+    constexpr std::string_view expected = "#####...####..##.....#####..##..\n"
+                                          "##..##.##..##.##.....##..##.##..\n"
+                                          "##..##.##..##.##.....##..##.##..\n"
+                                          "##..##.##..##.##.....#####..####\n"
+                                          "##..##.##..##.##.....#####...###\n"
+                                          "##..##.##..##.##.....##..##...##\n"
+                                          "##..##.##..##.##.....##..##...##\n"
+                                          "#####...####..######.#####....##\n";
+    EXPECT_EQ(ascii(display_renderer().render(display_state::Text{fixed_string<24>::from("DOLBY ATMOS")})), expected);
+}
+
+TEST(screens, scrolled_text)
+{
+    display_renderer renderer;
+    renderer.render(display_state::Text{fixed_string<24>::from("DOLBY ATMOS")});
+    constexpr std::string_view expected = "..##.....#####..##..##.....####.\n"
+                                          "#.##.....##..##.##..##....######\n"
+                                          "#.##.....##..##.##..##....##..##\n"
+                                          "#.##.....#####..######....##..##\n"
+                                          "#.##.....#####...####.....######\n"
+                                          "#.##.....##..##...##......##..##\n"
+                                          "#.##.....##..##...##......##..##\n"
+                                          "..######.#####....##......##..##\n";
+    EXPECT_EQ(ascii(renderer.scroll_text(12)), expected);
+}
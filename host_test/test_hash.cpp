@@ -0,0 +1,53 @@
+#include "util/hash/hash.h"
+#include "util/helper.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace
+{
+template <size_t N> std::string hex(const std::array<uint8_t, N> &digest)
+{
+    return esp32::format_hex(digest.data(), digest.size());
+}
+} // namespace
+
+TEST(hash, known_digests)
+{
+    EXPECT_EQ(hex(esp32::hash::sha256(std::string_view("abc"))), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    EXPECT_EQ(hex(esp32::hash::sha256(std::string_view())), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+
+    esp32::hash::hash<MBEDTLS_MD_SHA1> sha1;
+    sha1.update(std::string_view("abc"));
+    EXPECT_EQ(hex(sha1.finish()), "a9993e364706816aba3e25717850c26c9cd0d89d");
+    EXPECT_EQ(hex(esp32::hash::hash<MBEDTLS_MD_MD5>::compute(std::as_bytes(std::span("abc", 3)))), "900150983cd24fb0d6963f7d28e17f72");
+}
+
+TEST(hash, digest_sizes)
+{
+    static_assert(esp32::hash::digest_size<MBEDTLS_MD_SHA256>() == 32);
+    static_assert(std::tuple_size_v<esp32::hash::sha256_digest> == 32);
+    static_assert(std::tuple_size_v<esp32::hash::hash<MBEDTLS_MD_SHA512>::digest> == 64);
+    EXPECT_EQ(hex(esp32::hash::hash<MBEDTLS_MD_SHA512>::compute({})).size(), 128u);
+}
+
+TEST(hash, incremental_matches_one_shot)
+{
+    std::vector<uint8_t> data(10000);
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = static_cast<uint8_t>(i * 31);
+    }
+
+    const auto expected = esp32::hash::hash<MBEDTLS_MD_SHA256>::compute(std::as_bytes(std::span(data)));
+
+    // every update overload, split at odd sizes
+    esp32::hash::hash<MBEDTLS_MD_SHA256> hasher;
+    const auto bytes = std::span<const uint8_t>(data);
+    hasher.update(bytes.first(1));
+    hasher.update(std::as_bytes(bytes.subspan(1, 999)));
+    hasher.update(bytes.data() + 1000, 3000);
+    hasher.update(static_cast<const void *>(bytes.data() + 4000), 6000);
+    EXPECT_EQ(hasher.finish(), expected);
+
+    EXPECT_EQ(esp32::hash::sha256(bytes), expected);
+}
@@ -0,0 +1,28 @@
+#include "util/helper.h"
+#include <gtest/gtest.h>
+
+TEST(helper, hex)
+{
+    const std::vector<uint8_t> bytes{0x00, 0xab, 0x10};
+    EXPECT_EQ(esp32::format_hex(bytes), "00ab10");
+
+    std::vector<uint8_t> parsed;
+    EXPECT_TRUE(esp32::parse_hex("00ab10", parsed, 3));
+    EXPECT_EQ(parsed, bytes);
+    EXPECT_EQ(esp32::parse_hex<uint16_t>("abcd"), 0xabcd);
+}
+
+TEST(helper, strings)
+{
+    EXPECT_EQ(esp32::str_until("MV45 extra", ' '), "MV45");
+    EXPECT_TRUE(esp32::str_startswith("PSDYNVOL HEV", "PSDYNVOL"));
+    EXPECT_TRUE(esp32::string::equals_case_insensitive("Denon", "DENON"));
+    EXPECT_EQ(esp32::string::to_string(42u), "42");
+}
+
+TEST(helper, parse_number)
+{
+    EXPECT_EQ(esp32::string::parse_number<uint8_t>("255"), 255);
+    EXPECT_FALSE(esp32::string::parse_number<uint8_t>("256").has_value());
+    EXPECT_EQ(esp32::string::parse_number<int16_t>("-5"), -5);
+}
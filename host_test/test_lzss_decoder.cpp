@@ -0,0 +1,85 @@
+#include "lzss_encoder.h"
+#include "util/lzss_decoder.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <string_view>
+
+namespace
+{
+using decoder = esp32::lzss_decoder<10, 5>;
+
+std::vector<uint8_t> decode_in_chunks(std::span<const uint8_t> compressed, size_t chunk_size, bool &complete)
+{
+    decoder stream;
+    std::vector<uint8_t> output;
+    for (size_t offset = 0; offset < compressed.size(); offset += chunk_size)
+    {
+        stream.decode(compressed.subspan(offset, std::min(chunk_size, compressed.size() - offset)),
+                      [&output](uint8_t value) { output.push_back(value); });
+    }
+    complete = stream.is_complete();
+    return output;
+}
+
+// feedback frames repeat a lot, random bytes do not repeat at all
+std::vector<uint8_t> sample_data()
+{
+    std::vector<uint8_t> data;
+    constexpr std::string_view frames = "MV455\rMVMAX 98\rPWON\rMUOFF\rSIBD\rMSDOLBY DIGITAL\rPSDYNVOL MED\r";
+    std::mt19937 random(42);
+    for (int i = 0; i < 300; i++)
+    {
+        data.insert(data.end(), frames.begin(), frames.end());
+        for (int j = 0; j < 20; j++)
+        {
+            data.push_back(static_cast<uint8_t>(random()));
+        }
+    }
+    return data;
+}
+} // namespace
+
+TEST(lzss_decoder, decodes_heatshrink_bit_layout)
+{
+    // literal 'a', then a back reference of distance 1 and length 4, padded with zero bits
+    const std::array<uint8_t, 4> compressed{0xb0, 0x80, 0x01, 0x80};
+    bool complete = false;
+    const auto output = decode_in_chunks(compressed, compressed.size(), complete);
+    EXPECT_EQ(std::string(output.begin(), output.end()), "aaaaa");
+    EXPECT_TRUE(complete);
+}
+
+TEST(lzss_decoder, round_trip_in_any_chunk_size)
+{
+    const auto data = sample_data();
+    const auto compressed = lzss_encode<10, 5>(data);
+    EXPECT_LT(compressed.size(), data.size());
+
+    for (size_t chunk_size : {1, 3, 64, 4096})
+    {
+        bool complete = false;
+        EXPECT_EQ(decode_in_chunks(compressed, chunk_size, complete), data) << chunk_size;
+        EXPECT_TRUE(complete) << chunk_size;
+    }
+}
+
+TEST(lzss_decoder, truncated_stream_is_not_complete)
+{
+    const auto data = sample_data();
+    const auto compressed = lzss_encode<10, 5>(data);
+
+    bool complete = true;
+    const auto output = decode_in_chunks(std::span(compressed).first(compressed.size() / 2), 64, complete);
+    EXPECT_FALSE(complete);
+    EXPECT_LT(output.size(), data.size());
+    EXPECT_TRUE(std::equal(output.begin(), output.end(), data.begin()));
+}
+
+TEST(lzss_decoder, references_before_start_read_zeros)
+{
+    // heatshrink starts with a zeroed window, this is a back reference of distance 1024 and length 1
+    const std::array<uint8_t, 2> compressed{0x7f, 0xe0};
+    bool complete = false;
+    EXPECT_EQ(decode_in_chunks(compressed, 1, complete), std::vector<uint8_t>(1, 0));
+    EXPECT_TRUE(complete);
+}
@@ -0,0 +1,88 @@
+#include "host_flash.h"
+#include "util/ota_health_gate.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace std::chrono_literals;
+using health = esp32::ota_health_gate::health;
+
+namespace
+{
+class ota_health_gate_test : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        host_flash::reset();
+        host_flash::set_running_image_state(ESP_OTA_IMG_PENDING_VERIFY);
+    }
+
+    // the gate checks once a second
+    static bool wait_for_state(esp_ota_img_states_t state)
+    {
+        for (int i = 0; i < 300; i++)
+        {
+            if (host_flash::running_image_state() == state)
+            {
+                return true;
+            }
+            std::this_thread::sleep_for(10ms);
+        }
+        return false;
+    }
+};
+} // namespace
+
+TEST_F(ota_health_gate_test, confirms_healthy_image)
+{
+    esp32::ota_health_gate gate([] { return health::healthy; }, 0s, 0s);
+    gate.begin();
+    EXPECT_TRUE(wait_for_state(ESP_OTA_IMG_VALID));
+}
+
+TEST_F(ota_health_gate_test, rolls_back_failing_image_at_deadline)
+{
+    esp32::ota_health_gate gate([] { return health::failing; }, 0s, 0s);
+    gate.begin();
+    EXPECT_TRUE(wait_for_state(ESP_OTA_IMG_INVALID));
+}
+
+TEST_F(ota_health_gate_test, unknown_health_keeps_image_pending_past_deadline)
+{
+    std::atomic<health> state{health::unknown};
+    std::atomic<int> checks{0};
+    esp32::ota_health_gate gate(
+        [&] {
+            checks++;
+            return state.load();
+        },
+        0s, 0s);
+    gate.begin();
+
+    while (checks < 2)
+    {
+        std::this_thread::sleep_for(10ms);
+    }
+    EXPECT_EQ(host_flash::running_image_state(), ESP_OTA_IMG_PENDING_VERIFY);
+
+    // the avr answered at last
+    state = health::healthy;
+    EXPECT_TRUE(wait_for_state(ESP_OTA_IMG_VALID));
+}
+
+TEST_F(ota_health_gate_test, confirmed_image_is_left_alone)
+{
+    host_flash::set_running_image_state(ESP_OTA_IMG_VALID);
+    std::atomic<int> checks{0};
+    esp32::ota_health_gate gate(
+        [&] {
+            checks++;
+            return health::failing;
+        },
+        0s, 0s);
+    gate.begin();
+    std::this_thread::sleep_for(1200ms);
+    EXPECT_EQ(checks, 0);
+    EXPECT_EQ(host_flash::running_image_state(), ESP_OTA_IMG_VALID);
+}
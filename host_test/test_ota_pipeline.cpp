@@ -0,0 +1,132 @@
+#include "host_flash.h"
+#include "util/ota_pipeline.h"
+#include <gtest/gtest.h>
+#include <mutex>
+#include <random>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+constexpr auto chunk_size = esp32::ota_pipeline::chunk_size;
+constexpr auto chunk_count = esp32::ota_pipeline::chunk_count;
+
+std::vector<uint8_t> random_image(size_t size)
+{
+    std::vector<uint8_t> image(size);
+    std::mt19937 random(11);
+    for (auto &value : image)
+    {
+        value = static_cast<uint8_t>(random());
+    }
+    return image;
+}
+
+esp32::hash::sha256_digest digest_of(const std::vector<uint8_t> &image)
+{
+    return esp32::hash::sha256(std::span<const uint8_t>(image));
+}
+
+class ota_pipeline_test : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        host_flash::reset();
+    }
+
+    void TearDown() override
+    {
+        host_flash::reset();
+    }
+};
+} // namespace
+
+TEST_F(ota_pipeline_test, writes_image_through_slow_flash)
+{
+    constexpr auto flash_write_time = 2ms;
+    host_flash::set_write_delay(flash_write_time);
+    // not a multiple of the chunk size, so end() writes a partial chunk
+    const auto image = random_image(chunk_size * 12 + 123);
+
+    std::mutex progress_lock;
+    std::vector<esp32::ota_pipeline::progress> progress;
+    esp32::ota_pipeline pipeline(digest_of(image), esp32::ota_updator::encoding::raw, [&](const esp32::ota_pipeline::progress &update) {
+        std::lock_guard lock(progress_lock);
+        progress.push_back(update);
+    });
+    pipeline.begin();
+
+    // transport sized pieces that do not line up with the chunks
+    for (size_t offset = 0; offset < image.size(); offset += 1460)
+    {
+        pipeline.write(image.data() + offset, std::min<size_t>(1460, image.size() - offset));
+    }
+    pipeline.end(true);
+
+    EXPECT_EQ(host_flash::written_image(), image);
+    EXPECT_TRUE(host_flash::is_boot_partition_set());
+
+    std::lock_guard lock(progress_lock);
+    ASSERT_EQ(progress.size(), 13u);
+    EXPECT_EQ(progress.back().bytes_written, image.size());
+    EXPECT_EQ(progress.back().bytes_received, image.size());
+    for (size_t i = 1; i < progress.size(); i++)
+    {
+        EXPECT_GT(progress[i].bytes_written, progress[i - 1].bytes_written);
+    }
+    // every write took at least flash_write_time, which bounds the throughput
+    const auto max_rate = chunk_size * 1000 * 1000 / std::chrono::microseconds(flash_write_time).count();
+    EXPECT_GT(progress.back().bytes_per_second, 0u);
+    EXPECT_LE(progress.back().bytes_per_second, max_rate);
+}
+
+TEST_F(ota_pipeline_test, pushes_back_while_flash_is_busy)
+{
+    const auto image = random_image(chunk_size * (chunk_count + 2));
+    esp32::ota_pipeline pipeline(digest_of(image));
+    pipeline.begin();
+
+    host_flash::hold_writes(true);
+    // every chunk can be filled while the flash is busy, the writer holds the first one
+    pipeline.write(image.data(), chunk_size * chunk_count);
+    EXPECT_THROW(pipeline.write(image.data() + chunk_size * chunk_count, chunk_size, pdMS_TO_TICKS(50)), esp32::ota_exception);
+
+    // nothing was taken from the refused write, so the transport can retry it
+    host_flash::hold_writes(false);
+    pipeline.write(image.data() + chunk_size * chunk_count, image.size() - chunk_size * chunk_count);
+    pipeline.end();
+
+    EXPECT_EQ(host_flash::written_image(), image);
+}
+
+TEST_F(ota_pipeline_test, reports_flash_failure_to_the_caller)
+{
+    const auto image = random_image(chunk_size * 10);
+    esp32::ota_pipeline pipeline(digest_of(image));
+    pipeline.begin();
+    host_flash::fail_writes_after(chunk_size * 2);
+
+    EXPECT_THROW(
+        {
+            for (size_t offset = 0; offset < image.size(); offset += chunk_size)
+            {
+                pipeline.write(image.data() + offset, chunk_size);
+            }
+            pipeline.end();
+        },
+        esp32::ota_exception);
+
+    pipeline.abort();
+    EXPECT_FALSE(pipeline.is_running());
+    EXPECT_FALSE(host_flash::is_boot_partition_set());
+}
+
+TEST_F(ota_pipeline_test, stops_writer_when_destroyed)
+{
+    const auto image = random_image(chunk_size * 2);
+    esp32::ota_pipeline pipeline(digest_of(image));
+    pipeline.begin();
+    pipeline.write(image.data(), chunk_size + 10);
+    // leaves without end() or abort(), e.g. when the transport threw
+}
@@ -0,0 +1,104 @@
+#include "firmware_image.h"
+#include "host_flash.h"
+#include "lzss_encoder.h"
+#include "util/ota.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+void write_in_chunks(esp32::ota_updator &updator, std::span<const uint8_t> data, size_t chunk_size)
+{
+    for (size_t offset = 0; offset < data.size(); offset += chunk_size)
+    {
+        updator.write(data.data() + offset, std::min(chunk_size, data.size() - offset));
+    }
+}
+
+class ota_updator_test : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        host_flash::reset();
+    }
+};
+} // namespace
+
+TEST_F(ota_updator_test, hashes_while_writing)
+{
+    const auto image = firmware_image(30000);
+    esp32::ota_updator updator(esp32::hash::sha256(std::span<const uint8_t>(image)));
+    write_in_chunks(updator, image, 4096);
+
+    // the digest comes from the written data, so flash is only read back when asked for
+    host_flash::corrupt(100);
+    updator.end();
+
+    EXPECT_TRUE(host_flash::is_boot_partition_set());
+}
+
+TEST_F(ota_updator_test, rejects_wrong_digest)
+{
+    const auto image = firmware_image(30000);
+    auto expected = esp32::hash::sha256(std::span<const uint8_t>(image));
+    expected[0] ^= 1;
+
+    esp32::ota_updator updator(expected);
+    write_in_chunks(updator, image, 4096);
+    EXPECT_THROW(updator.end(), esp32::ota_exception);
+    EXPECT_FALSE(host_flash::is_boot_partition_set());
+}
+
+TEST_F(ota_updator_test, verify_flash_finds_corrupted_write)
+{
+    const auto image = firmware_image(30000);
+    esp32::ota_updator updator(esp32::hash::sha256(std::span<const uint8_t>(image)));
+    write_in_chunks(updator, image, 4096);
+
+    host_flash::corrupt(image.size() - 1);
+    try
+    {
+        updator.end(true);
+        FAIL() << "corrupted flash not detected";
+    }
+    catch (const esp32::ota_exception &ex)
+    {
+        EXPECT_EQ(ex.get_error(), ESP_ERR_INVALID_CRC);
+    }
+    EXPECT_FALSE(host_flash::is_boot_partition_set());
+}
+
+TEST_F(ota_updator_test, reports_failed_flash_write)
+{
+    const auto image = firmware_image(30000);
+    esp32::ota_updator updator(esp32::hash::sha256(std::span<const uint8_t>(image)));
+    host_flash::fail_writes_after(10000);
+    EXPECT_THROW(write_in_chunks(updator, image, 4096), esp32::ota_exception);
+    updator.abort();
+    EXPECT_FALSE(updator.is_running());
+}
+
+TEST_F(ota_updator_test, writes_compressed_image)
+{
+    const auto image = firmware_image(50000);
+    const auto compressed = lzss_encode<10, 5>(image);
+    ASSERT_LT(compressed.size(), image.size());
+
+    esp32::ota_updator updator(esp32::hash::sha256(std::span<const uint8_t>(image)), esp32::ota_updator::encoding::lzss);
+    write_in_chunks(updator, compressed, 1000);
+    updator.end(true);
+
+    EXPECT_EQ(host_flash::written_image(), image);
+    EXPECT_TRUE(host_flash::is_boot_partition_set());
+}
+
+TEST_F(ota_updator_test, rejects_truncated_compressed_image)
+{
+    const auto image = firmware_image(20000);
+    const auto compressed = lzss_encode<10, 5>(image);
+
+    esp32::ota_updator updator(esp32::hash::sha256(std::span<const uint8_t>(image)), esp32::ota_updator::encoding::lzss);
+    write_in_chunks(updator, std::span(compressed).first(compressed.size() - 10), 1000);
+    EXPECT_THROW(updator.end(), esp32::ota_exception);
+    EXPECT_FALSE(host_flash::is_boot_partition_set());
+}
@@ -0,0 +1,120 @@
+#include "denon_commands.h"
+#include "util/prefix_dispatch.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr esp32::prefix_dispatch<size_t, denon_command_prefixes.size()> denon_dispatch{
+    make_handlers<size_t>(denon_command_prefixes, [](size_t i) { return i; })};
+
+// every prefix finds itself, also when followed by arguments
+constexpr bool finds_all_prefixes()
+{
+    for (size_t i = 0; i < denon_command_prefixes.size(); i++)
+    {
+        const auto entry = denon_dispatch.find(denon_command_prefixes[i]);
+        if (entry == nullptr || entry->handler != i)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(finds_all_prefixes());
+static_assert(denon_dispatch.find("MV455")->prefix == "MV");
+static_assert(denon_dispatch.find("MVMAX 98")->prefix == "MVMAX");
+static_assert(denon_dispatch.find("SIUSB/IPOD")->prefix == "SIUSB/IPOD");
+static_assert(denon_dispatch.find("SIUSB")->prefix == "SIUSB");
+static_assert(denon_dispatch.find("Z2CV FL 50")->prefix == "Z2CV");
+static_assert(denon_dispatch.find("Z250")->prefix == "Z2");
+static_assert(denon_dispatch.find("PSDYNVOL MED")->prefix == "PSDYNVOL");
+static_assert(denon_dispatch.find("MVMA")->prefix == "MV");
+static_assert(denon_dispatch.find("PSDYNVO") == nullptr);
+static_assert(denon_dispatch.find("PSXYZ") == nullptr);
+static_assert(denon_dispatch.find("QQ") == nullptr);
+static_assert(denon_dispatch.find("M") == nullptr);
+static_assert(denon_dispatch.find("") == nullptr);
+
+// every two letter group from AA to ZZ, far more than the protocol has
+constexpr size_t letters = 26;
+constexpr auto all_group_names = [] {
+    std::array<char, letters * letters * 2> names{};
+    for (size_t i = 0; i < letters * letters; i++)
+    {
+        names[i * 2] = static_cast<char>('A' + i / letters);
+        names[i * 2 + 1] = static_cast<char>('A' + i % letters);
+    }
+    return names;
+}();
+
+constexpr auto all_groups = [] {
+    std::array<std::string_view, letters * letters> groups{};
+    for (size_t i = 0; i < groups.size(); i++)
+    {
+        groups[i] = std::string_view(all_group_names.data() + i * 2, 2);
+    }
+    return groups;
+}();
+
+constexpr esp32::prefix_dispatch<size_t, all_groups.size()> all_groups_dispatch{
+    make_handlers<size_t>(all_groups, [](size_t i) { return i; })};
+
+constexpr bool finds_all_groups()
+{
+    for (size_t i = 0; i < all_groups.size(); i++)
+    {
+        const auto entry = all_groups_dispatch.find(all_groups[i]);
+        if (entry == nullptr || entry->handler != i)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(finds_all_groups());
+static_assert(all_groups_dispatch.find("Aa") == nullptr);
+static_assert(all_groups_dispatch.find("09") == nullptr);
+// nested prefixes of every length up to the longest allowed, all in one group
+constexpr std::string_view nested_prefix = "PS345678901234567890123456789012";
+constexpr auto nested = [] {
+    std::array<esp32::prefix_handler<size_t>, 30> handlers{};
+    for (size_t i = 0; i < handlers.size(); i++)
+    {
+        handlers[i] = {nested_prefix.substr(0, i + 2), i + 2};
+    }
+    return handlers;
+}();
+constexpr esp32::prefix_dispatch<size_t, nested.size()> nested_dispatch{nested};
+
+static_assert(nested_dispatch.find(nested_prefix)->handler == 31);
+static_assert(nested_dispatch.find("PS34567")->handler == 7);
+static_assert(nested_dispatch.find("PS34X")->handler == 4);
+static_assert(nested_dispatch.find("PS")->handler == 2);
+static_assert(nested_dispatch.find("PX") == nullptr);
+} // namespace
+
+TEST(prefix_dispatch, longest_prefix_wins_at_runtime)
+{
+    // same lookups as above, through a non constant command
+    std::string command = "MVMAX 98";
+    EXPECT_EQ(denon_dispatch.find(command)->prefix, "MVMAX");
+    command = "MV45";
+    EXPECT_EQ(denon_dispatch.find(command)->prefix, "MV");
+    command = "MSDOLBY DIGITAL";
+    EXPECT_EQ(denon_dispatch.find(command)->prefix, "MSDOLBY DIGITAL");
+    command = "XX";
+    EXPECT_EQ(denon_dispatch.find(command), nullptr);
+}
+
+TEST(prefix_dispatch, every_group_of_two_letters)
+{
+    for (size_t i = 0; i < all_groups.size(); i++)
+    {
+        const auto command = std::string(all_groups[i]) + "ARGS";
+        const auto entry = all_groups_dispatch.find(command);
+        ASSERT_NE(entry, nullptr) << command;
+        EXPECT_EQ(entry->handler, i);
+    }
+}
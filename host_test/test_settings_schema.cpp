@@ -0,0 +1,56 @@
+#include "config/settings_schema.h"
+#include <gtest/gtest.h>
+
+using namespace settings_schema;
+
+namespace
+{
+constexpr size_t volume_bar_offset = 2;
+} // namespace
+
+TEST(settings_schema, round_trip)
+{
+    auto stored = defaults();
+    stored.screen_brightness = 3;
+    stored.volume_bar = true;
+    stored.fade_interval_ms = 250;
+    stored.fade_curve = fade_curve_t::linear;
+
+    const auto blob = serialize(stored);
+    const auto loaded = deserialize(blob);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->screen_brightness, 3);
+    EXPECT_TRUE(loaded->volume_bar);
+    EXPECT_EQ(loaded->fade_interval_ms, 250);
+    EXPECT_EQ(loaded->fade_curve, fade_curve_t::linear);
+}
+
+TEST(settings_schema, short_blob_keeps_defaults)
+{
+    const std::array<uint8_t, 3> blob{version, 12, 1};
+    const auto loaded = deserialize(blob);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->screen_brightness, 12);
+    EXPECT_TRUE(loaded->volume_bar);
+    EXPECT_EQ(loaded->display_off_timeout_s, display_off_timeout_s.default_value);
+    EXPECT_EQ(loaded->fade_interval_ms, fade_interval_ms.default_value);
+}
+
+TEST(settings_schema, out_of_range_values)
+{
+    auto blob = serialize(defaults());
+    blob[1] = 200;
+    blob[volume_bar_offset] = 0x5a;
+    const auto loaded = deserialize(blob);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->screen_brightness, screen_brightness.max);
+    EXPECT_EQ(loaded->volume_bar, volume_bar.default_value);
+}
+
+TEST(settings_schema, unknown_version)
+{
+    auto blob = serialize(defaults());
+    blob[0] = version + 1;
+    EXPECT_FALSE(deserialize(blob).has_value());
+    EXPECT_FALSE(deserialize(std::span<const uint8_t>()).has_value());
+}
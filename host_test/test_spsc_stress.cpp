@@ -0,0 +1,157 @@
+#include "hardware/uart/command_processor.h"
+#include "util/spsc_circular_buffer.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <charconv>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace
+{
+// frame of sequence number n: "S<n> " followed by n % 40 copies of one letter derived from n
+std::string make_frame(uint32_t sequence)
+{
+    auto frame = "S" + std::to_string(sequence) + " ";
+    frame.append(sequence % 40, static_cast<char>('A' + sequence % 26));
+    return frame;
+}
+
+// the sequence number of a frame that is intact, nothing if it is torn
+std::optional<uint32_t> parse_frame(std::string_view frame)
+{
+    uint32_t sequence = 0;
+    if (frame.size() < 3 || frame[0] != 'S')
+    {
+        return std::nullopt;
+    }
+    const auto [end, error] = std::from_chars(frame.data() + 1, frame.data() + frame.size(), sequence);
+    if (error != std::errc() || end == frame.data() + frame.size() || *end != ' ')
+    {
+        return std::nullopt;
+    }
+    return frame == make_frame(sequence) ? std::optional(sequence) : std::nullopt;
+}
+} // namespace
+
+TEST(spsc_stress, ring_keeps_order_across_threads)
+{
+    constexpr uint64_t count = 5'000'000;
+    spsc_circular_buffer<uint64_t, 16> ring;
+
+    std::thread producer([&ring] {
+        for (uint64_t value = 0; value < count; value++)
+        {
+            while (!ring.push(value))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t expected = 0;
+    uint64_t out_of_order = 0;
+    while (expected < count)
+    {
+        uint64_t value;
+        if (!ring.pop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        out_of_order += value != expected;
+        expected = value + 1;
+    }
+    producer.join();
+
+    EXPECT_EQ(out_of_order, 0u);
+    EXPECT_TRUE(ring.is_empty());
+}
+
+TEST(spsc_stress, command_processor_frames_across_threads)
+{
+    constexpr uint32_t count = 2'000'000;
+    command_processor processor;
+    std::atomic<bool> producer_done{false};
+    uint64_t frames_queued = 0;
+
+    std::thread producer([&] {
+        // uart reads end anywhere, also in the middle of a frame
+        std::mt19937 random(5);
+        std::string stream;
+        uint32_t sequence = 0;
+        while (sequence < count || !stream.empty())
+        {
+            while (stream.size() < 512 && sequence < count)
+            {
+                stream += make_frame(sequence++);
+                stream += '\r';
+            }
+            const auto read = std::min<size_t>(stream.size(), 1 + random() % 120);
+            frames_queued += processor.add_data(std::string_view(stream).substr(0, read));
+            stream.erase(0, read);
+            if (random() % 8 == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        producer_done = true;
+    });
+
+    uint64_t received = 0;
+    uint64_t torn = 0;
+    uint64_t out_of_order = 0;
+    uint64_t missing_bytes = 0;
+    int64_t last = -1;
+    command_processor::frame frame;
+    const auto consume = [&] {
+        const auto sequence = parse_frame(frame.view());
+        if (!sequence)
+        {
+            torn++;
+            return;
+        }
+        if (static_cast<int64_t>(*sequence) <= last)
+        {
+            out_of_order++;
+            return;
+        }
+        for (auto missing = last + 1; missing < static_cast<int64_t>(*sequence); missing++)
+        {
+            missing_bytes += make_frame(static_cast<uint32_t>(missing)).size();
+        }
+        last = *sequence;
+        received++;
+    };
+
+    while (!producer_done)
+    {
+        if (processor.pop_command(frame))
+        {
+            consume();
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    while (processor.pop_command(frame))
+    {
+        consume();
+    }
+    for (auto missing = last + 1; missing < static_cast<int64_t>(count); missing++)
+    {
+        missing_bytes += make_frame(static_cast<uint32_t>(missing)).size();
+    }
+
+    const auto stats = processor.get_loss_stats();
+    EXPECT_EQ(torn, 0u);
+    EXPECT_EQ(out_of_order, 0u);
+    EXPECT_EQ(received, frames_queued);
+    // every frame is either received or counted as dropped, with its length
+    EXPECT_EQ(received + stats.frames_dropped, count);
+    EXPECT_EQ(stats.bytes_dropped, missing_bytes);
+    EXPECT_EQ(stats.overflow_events, 0u);
+    EXPECT_GT(received, 0u);
+}
@@ -0,0 +1,52 @@
+#include "util/static_queue.h"
+#include "util/task_wrapper.h"
+#include <atomic>
+#include <gtest/gtest.h>
+
+TEST(static_queue, fifo_order)
+{
+    esp32::static_queue<int, 4> queue;
+    EXPECT_TRUE(queue.is_empty());
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_TRUE(queue.enqueue(i, 0));
+    }
+    EXPECT_FALSE(queue.enqueue(4, 0));
+
+    int value = -1;
+    EXPECT_TRUE(queue.peek(value, 0));
+    EXPECT_EQ(value, 0);
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_TRUE(queue.dequeue(value, 0));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.dequeue(value, pdMS_TO_TICKS(5)));
+}
+
+TEST(static_queue, blocks_producer_until_consumer_catches_up)
+{
+    esp32::static_queue<int, 2> queue;
+    std::atomic<int> sum{0};
+    esp32::task consumer([&] {
+        int value;
+        while (true)
+        {
+            queue.dequeue(value, portMAX_DELAY);
+            sum += value;
+        }
+    });
+    ASSERT_EQ(consumer.spawn("consumer", 4096, esp32::task::default_priority), ESP_OK);
+
+    for (int i = 1; i <= 100; i++)
+    {
+        ASSERT_TRUE(queue.enqueue(i, portMAX_DELAY));
+    }
+    while (!queue.is_empty())
+    {
+        vTaskDelay(1);
+    }
+    vTaskDelay(pdMS_TO_TICKS(5));
+    EXPECT_EQ(sum.load(), 5050);
+    consumer.kill();
+}
@@ -0,0 +1,96 @@
+#include "trace_replayer.h"
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+// a power on with a volume change, mute, input and surround mode switch, as the uart task records it:
+// chunks end where uart_read_bytes returned, also in the middle of a frame
+const std::array<uart_trace::record, 9> session{{
+    {1'250'000us, "PWON\r"},
+    {1'270'000us, "MVMAX 98\rMV4"},
+    {1'271'000us, "55\r"},
+    {1'700'000us, "MUON\r"},
+    {2'400'000us, "MUOFF\rSIBD\r"},
+    {2'950'000us, "PSDYNVOL MED\r"},
+    {3'400'000us, "MSDOLBY "},
+    {3'401'000us, "ATMOS\r"},
+    {3'450'000us, "MV50\r"},
+}};
+
+std::vector<uint8_t> record_session()
+{
+    std::array<uint8_t, 256> buffer;
+    uart_trace::writer writer(buffer);
+    for (auto &&record : session)
+    {
+        EXPECT_TRUE(writer.append(record.time, record.data));
+    }
+    const auto trace = writer.data();
+    return std::vector<uint8_t>(trace.begin(), trace.end());
+}
+} // namespace
+
+TEST(trace_replay, feeds_every_frame_through)
+{
+    trace_replayer replayer;
+    ASSERT_TRUE(replayer.replay(record_session()));
+    replayer.print_report(stdout);
+
+    EXPECT_EQ(replayer.records(), session.size());
+    EXPECT_EQ(replayer.frames(), 9u);
+    // MVMAX only rescales the volume bar
+    EXPECT_EQ(replayer.display_states(), 8u);
+    EXPECT_EQ(replayer.get_loss_stats().frames_dropped, 0u);
+    for (auto stage : {trace_replayer::stage::framing, trace_replayer::stage::parse})
+    {
+        EXPECT_EQ(replayer.latency(stage).count(), replayer.frames());
+    }
+    for (auto stage : {trace_replayer::stage::render, trace_replayer::stage::end_to_end})
+    {
+        EXPECT_EQ(replayer.latency(stage).count(), replayer.display_states());
+    }
+
+    // the last frame, MV50, shows the volume bar at 50 of 98 dB
+    display_renderer renderer;
+    EXPECT_EQ(replayer.last_frame(), renderer.render(display_state::Volume{100}));
+}
+
+TEST(trace_replay, keeps_recorded_pace)
+{
+    // 2.2 s of trace at 100 times the speed
+    trace_replayer replayer(100);
+    ASSERT_TRUE(replayer.replay(record_session()));
+    replayer.print_report(stdout);
+
+    EXPECT_GE(replayer.elapsed(), 22ms);
+    EXPECT_LT(replayer.busy(), replayer.elapsed());
+    EXPECT_EQ(replayer.frames(), 9u);
+}
+
+TEST(trace_replay, stops_at_truncated_trace)
+{
+    auto trace = record_session();
+    trace.resize(trace.size() - 3);
+
+    trace_replayer replayer;
+    EXPECT_FALSE(replayer.replay(trace));
+    EXPECT_EQ(replayer.records(), session.size() - 1);
+}
+
+TEST(trace_replay, captured_log)
+{
+    // the session above as denon_avr::log_trace printed it
+    std::ifstream file(TRACE_DIR "/session.log");
+    ASSERT_TRUE(file);
+    const auto trace = trace_replayer::from_log(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+    EXPECT_EQ(trace, record_session());
+
+    trace_replayer replayer;
+    ASSERT_TRUE(replayer.replay(trace));
+    EXPECT_EQ(replayer.frames(), 9u);
+}
@@ -0,0 +1,56 @@
+#include "hardware/uart/uart_trace.h"
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+TEST(uart_trace, round_trip)
+{
+    std::array<uint8_t, 64> buffer;
+    uart_trace::writer writer(buffer);
+    ASSERT_TRUE(writer.append(1000us, "MV45\r"));
+    ASSERT_TRUE(writer.append(1500us, "MUON\rPW"));
+    ASSERT_TRUE(writer.append(300000us, "ON\r"));
+
+    uart_trace::reader reader(writer.data());
+    ASSERT_TRUE(reader.is_valid());
+    const std::array<uart_trace::record, 3> expected{{{1000us, "MV45\r"}, {1500us, "MUON\rPW"}, {300000us, "ON\r"}}};
+    for (auto &&record : expected)
+    {
+        const auto read = reader.next();
+        ASSERT_TRUE(read.has_value());
+        EXPECT_EQ(read->time, record.time);
+        EXPECT_EQ(read->data, record.data);
+    }
+
+    // the clean end of a trace is not an error
+    EXPECT_TRUE(reader.at_end());
+    EXPECT_FALSE(reader.next().has_value());
+    EXPECT_TRUE(reader.is_valid());
+}
+
+TEST(uart_trace, full_buffer_keeps_trace)
+{
+    std::array<uint8_t, 12> buffer;
+    uart_trace::writer writer(buffer);
+    ASSERT_TRUE(writer.append(1us, "MUON"));
+    const auto size = writer.data().size();
+    EXPECT_FALSE(writer.append(2us, "MUOFF"));
+    EXPECT_EQ(writer.data().size(), size);
+}
+
+TEST(uart_trace, truncated_trace_is_invalid)
+{
+    std::array<uint8_t, 64> buffer;
+    uart_trace::writer writer(buffer);
+    ASSERT_TRUE(writer.append(1000us, "MV45\r"));
+    ASSERT_TRUE(writer.append(2000us, "MUON\r"));
+
+    const auto trace = writer.data();
+    uart_trace::reader reader(trace.first(trace.size() - 2));
+    ASSERT_TRUE(reader.next().has_value());
+    EXPECT_FALSE(reader.next().has_value());
+    EXPECT_FALSE(reader.is_valid());
+
+    const std::array<uint8_t, 4> wrong_magic{'D', 'T', 'R', '0'};
+    EXPECT_FALSE(uart_trace::reader(wrong_magic).is_valid());
+}
@@ -0,0 +1,247 @@
+#pragma once
+
+#include "display_renderer.h"
+#include "hardware/display/feedback_decoder.h"
+#include "hardware/uart/avr_state_parser.h"
+#include "hardware/uart/command_processor.h"
+#include "hardware/uart/uart_trace.h"
+#include "util/log2_histogram.h"
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <span>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Feeds a recorded UART trace (see uart_trace.h) through the feedback path the uart and gui tasks run
+ * on target: framing in command_processor, avr_state_parser, feedback_decoder and the drawing of the
+ * display, and measures every stage.
+ *
+ * Chunks are handed over at their recorded time divided by speed, so 1 replays in real time and 10
+ * ten times faster; with speed 0 they follow each other as fast as the path takes them.
+ */
+class trace_replayer
+{
+  public:
+    enum class stage : uint8_t
+    {
+        // chunk handed to add_data until its frame was popped
+        framing,
+        parse,
+        decode,
+        render,
+        // chunk handed to add_data until the frame it completed was drawn
+        end_to_end,
+        count,
+    };
+
+    explicit trace_replayer(double speed = 0) : speed_(speed)
+    {
+    }
+
+    /**
+     * Returns false if the trace is not valid or is truncated, the records before that are replayed.
+     */
+    bool replay(std::span<const uint8_t> trace)
+    {
+        using clock = std::chrono::steady_clock;
+        uart_trace::reader reader(trace);
+        const auto start = clock::now();
+        std::optional<std::chrono::microseconds> first_time;
+        command_processor::frame frame;
+
+        while (const auto record = reader.next())
+        {
+            if (!first_time)
+            {
+                first_time = record->time;
+            }
+            if (speed_ > 0)
+            {
+                const auto offset = std::chrono::duration<double, std::micro>(record->time - *first_time) / speed_;
+                std::this_thread::sleep_until(start + std::chrono::duration_cast<clock::duration>(offset));
+            }
+
+            const auto received = clock::now();
+            records_++;
+            bytes_ += record->data.size();
+            processor_.add_data(record->data);
+            auto mark = received;
+            const auto lap = [&](stage stage) {
+                const auto now = clock::now();
+                record_latency(stage, now - mark);
+                mark = now;
+            };
+            while (processor_.pop_command(frame))
+            {
+                frames_++;
+                lap(stage::framing);
+                const auto delta = avr_state_parser::parse(frame.view());
+                lap(stage::parse);
+                if (!delta.has_value())
+                {
+                    continue;
+                }
+                const auto value = feedback_decoder::decode(*delta);
+                lap(stage::decode);
+                if (!value.has_value())
+                {
+                    continue;
+                }
+                last_frame_ = renderer_.render(*value);
+                lap(stage::render);
+                record_latency(stage::end_to_end, mark - received);
+                display_states_++;
+            }
+            busy_ += clock::now() - received;
+        }
+
+        elapsed_ += clock::now() - start;
+        return reader.is_valid();
+    }
+
+    /**
+     * The trace denon_avr::log_trace wrote: the hex lines between "UART trace begin" and "UART trace end",
+     * with or without the log prefix in front of them.
+     */
+    static std::vector<uint8_t> from_log(const std::string &log)
+    {
+        std::vector<uint8_t> trace;
+        std::istringstream lines(log);
+        std::string line;
+        bool in_trace = log.find("UART trace begin") == std::string::npos;
+        while (std::getline(lines, line))
+        {
+            if (line.find("UART trace begin") != std::string::npos)
+            {
+                in_trace = true;
+                continue;
+            }
+            if (line.find("UART trace end") != std::string::npos)
+            {
+                break;
+            }
+
+            // the hex is the last word, after the log level, timestamp and tag
+            while (!line.empty() && isspace(static_cast<unsigned char>(line.back())))
+            {
+                line.pop_back();
+            }
+            const auto word = line.substr(line.find_last_of(' ') + 1);
+            if (!in_trace || word.empty() || word.size() % 2 || word.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)
+            {
+                continue;
+            }
+            for (size_t i = 0; i < word.size(); i += 2)
+            {
+                trace.push_back(static_cast<uint8_t>(std::stoul(word.substr(i, 2), nullptr, 16)));
+            }
+        }
+        return trace;
+    }
+
+    size_t records() const
+    {
+        return records_;
+    }
+
+    size_t bytes() const
+    {
+        return bytes_;
+    }
+
+    size_t frames() const
+    {
+        return frames_;
+    }
+
+    /**
+     * Frames that changed what the display shows.
+     */
+    size_t display_states() const
+    {
+        return display_states_;
+    }
+
+    const frame_buffer &last_frame() const
+    {
+        return last_frame_;
+    }
+
+    command_processor::loss_stats get_loss_stats() const
+    {
+        return processor_.get_loss_stats();
+    }
+
+    /**
+     * Wall time of the replay, including the waits between records.
+     */
+    std::chrono::nanoseconds elapsed() const
+    {
+        return elapsed_;
+    }
+
+    /**
+     * Time spent in the feedback path.
+     */
+    std::chrono::nanoseconds busy() const
+    {
+        return busy_;
+    }
+
+    /**
+     * Latency of a stage in nanoseconds.
+     */
+    const log2_histogram &latency(stage stage) const
+    {
+        return latencies_[static_cast<size_t>(stage)];
+    }
+
+    void print_report(FILE *out) const
+    {
+        constexpr static std::array<const char *, static_cast<size_t>(stage::count)> stage_names = {
+            "framing", "parse", "decode", "render", "end to end",
+        };
+
+        const auto busy_seconds = std::chrono::duration<double>(busy_).count();
+        fprintf(out, "%zu records, %zu bytes, %zu frames, %zu display states in %.3f ms (%.3f ms busy)\n", records_, bytes_, frames_,
+                display_states_, std::chrono::duration<double, std::milli>(elapsed_).count(), busy_seconds * 1000);
+        if (busy_seconds > 0)
+        {
+            fprintf(out, "throughput %.0f frames/s, %.0f bytes/s\n", frames_ / busy_seconds, bytes_ / busy_seconds);
+        }
+        const auto loss = get_loss_stats();
+        fprintf(out, "dropped %" PRIu32 " frames, %" PRIu32 " bytes, %" PRIu32 " overflows\n", loss.frames_dropped, loss.bytes_dropped,
+                loss.overflow_events);
+        for (size_t i = 0; i < latencies_.size(); i++)
+        {
+            auto &&histogram = latencies_[i];
+            // bucket bounds above the largest value say less than the value itself
+            const auto percentile = [&](uint8_t percent) { return std::min(histogram.percentile(percent), histogram.max()); };
+            fprintf(out, "%-10s n=%" PRIu32 " p50<=%" PRIu32 "ns p90<=%" PRIu32 "ns p99<=%" PRIu32 "ns max=%" PRIu32 "ns\n",
+                    stage_names[i], histogram.count(), percentile(50), percentile(90), percentile(99), histogram.max());
+        }
+    }
+
+  private:
+    double speed_;
+    command_processor processor_;
+    display_renderer renderer_;
+    frame_buffer last_frame_;
+    size_t records_{0};
+    size_t bytes_{0};
+    size_t frames_{0};
+    size_t display_states_{0};
+    std::chrono::nanoseconds elapsed_{0};
+    std::chrono::nanoseconds busy_{0};
+    std::array<log2_histogram, static_cast<size_t>(stage::count)> latencies_;
+
+    void record_latency(stage stage, std::chrono::nanoseconds latency)
+    {
+        const auto value = std::clamp<int64_t>(latency.count(), 0, UINT32_MAX);
+        latencies_[static_cast<size_t>(stage)].record(static_cast<uint32_t>(value));
+    }
+};
@@ -1,16 +1,25 @@
 #pragma once
 
-#include <esp_event.h>
-
-ESP_EVENT_DECLARE_BASE(APP_COMMON_EVENT);
+#include "hardware/uart/avr_state.h"
+#include "util/event_bus.h"
 
 typedef enum
 {
     /** App init done*/
     APP_INIT_DONE,
 
-    NEW_FEEDBACK_RECEIVED,
+    /** Payload is avr_state_update, posted on the priority lane*/
+    AVR_STATE_CHANGED,
 
     CONFIG_CHANGE,
 
+    /** Changed settings have been quiet long enough to be written to flash*/
+    CONFIG_COMMIT_DUE,
+
+    APP_EVENT_COUNT,
 } esp_app_common_event_t;
+
+using app_event_bus = esp32::event_bus<APP_EVENT_COUNT, sizeof(avr_state_update)>;
+
+template <typename T> using app_event_subscriber_typed = esp32::event_subscriber_typed<app_event_bus, T>;
+using app_event_subscriber = app_event_subscriber_typed<void>;
@@ -1,37 +1,103 @@
 #include "config_manager.h"
-#include "app_events.h"
 #include "logging/logging_tags.h"
-#include "util/default_event.h"
 #include "util/helper.h"
 #include <esp_log.h>
-#include <filesystem>
 
-constexpr std::string_view screen_brightness_key{"scrn_brightness"};
+constexpr std::string_view settings_key{"settings"};
+
+// version 0 stored every setting under its own key
+constexpr std::string_view legacy_screen_brightness_key{"scrn_brightness"};
+constexpr std::string_view legacy_volume_bar_key{"volume_bar"};
 
 void config::begin()
 {
     ESP_LOGD(CONFIG_TAG, "Loading Configuration");
 
     nvs_storage_.begin("nvs", "config");
-    ESP_LOGI(CONFIG_TAG, "Screen brightness:%d", get_screen_brightness());
+
+    std::array<uint8_t, settings_schema::blob_size> blob{};
+    const auto stored_size = nvs_storage_.get_blob(settings_key, blob);
+    if (stored_size.has_value())
+    {
+        const auto values = settings_schema::deserialize(std::span(blob.data(), std::min(*stored_size, blob.size())));
+        if (values.has_value())
+        {
+            values_ = *values;
+        }
+        else
+        {
+            ESP_LOGW(CONFIG_TAG, "Unknown settings version:%d, using defaults", blob[0]);
+        }
+    }
+    else
+    {
+        migrate_from_keys();
+    }
+    instance_commit_event_.subscribe();
+
+    ESP_LOGI(CONFIG_TAG, "Screen brightness:%d", get(settings_schema::screen_brightness));
+}
+
+void config::migrate_from_keys()
+{
+    using namespace settings_schema;
+    values_.screen_brightness = screen_brightness.clamp(nvs_storage_.get(legacy_screen_brightness_key, screen_brightness.default_value));
+    values_.volume_bar = nvs_storage_.get(legacy_volume_bar_key, volume_bar.default_value);
+
+    ESP_LOGI(CONFIG_TAG, "Migrating settings to version %d", version);
+    dirty_ = true;
+    save();
+    nvs_storage_.erase(legacy_screen_brightness_key);
+    nvs_storage_.erase(legacy_volume_bar_key);
+    nvs_storage_.commit();
 }
 
 void config::save()
 {
+    if (!dirty_.exchange(false))
+    {
+        return;
+    }
+
     ESP_LOGI(CONFIG_TAG, "config save");
+    const auto blob = settings_schema::serialize(snapshot());
+    std::lock_guard<esp32::semaphore> lock(data_mutex_);
+    nvs_storage_.save_blob(settings_key, blob);
     nvs_storage_.commit();
-    CHECK_THROW_ESP(esp32::event_post(APP_COMMON_EVENT, CONFIG_CHANGE));
 }
 
-uint8_t config::get_screen_brightness()
+settings_schema::values config::snapshot() const
 {
-    std::lock_guard<esp32::semaphore> lock(data_mutex_);
-    const auto value = nvs_storage_.get(screen_brightness_key, static_cast<uint8_t>(8));
-    return value;
+    taskENTER_CRITICAL(&values_lock_);
+    const auto values = values_;
+    taskEXIT_CRITICAL(&values_lock_);
+    return values;
 }
 
-void config::set_screen_brightness(uint8_t screen_brightness)
+void config::changed()
 {
-    std::lock_guard<esp32::semaphore> lock(data_mutex_);
-    nvs_storage_.save(screen_brightness_key, screen_brightness);
+    dirty_ = true;
+    commit_timer_.restart_one_shot(commit_delay_);
+    // the value is already set, so a full lane only delays listeners until the next change; the bus counts the drop
+    if (app_event_bus::instance().post(CONFIG_CHANGE) != ESP_OK)
+    {
+        ESP_LOGW(CONFIG_TAG, "Dropped config change event");
+    }
+}
+
+void config::commit_timer_fired(void *arg)
+{
+    // flash writes block, so they are left to the event task instead of the timer task
+    if (app_event_bus::instance().post(CONFIG_COMMIT_DUE) != ESP_OK)
+    {
+        // the lane is full for now, try again after another commit delay instead of waiting for the next change
+        ESP_LOGW(CONFIG_TAG, "Config commit event dropped, retrying");
+        auto p_this = reinterpret_cast<config *>(arg);
+        p_this->commit_timer_.restart_one_shot(p_this->commit_delay_);
+    }
+}
+
+void config::commit_due(void *context, int32_t)
+{
+    static_cast<config *>(context)->save();
 }
@@ -1,22 +1,51 @@
 #pragma once
 
+#include "app_events.h"
 #include "preferences.h"
+#include "settings_schema.h"
 #include "util/noncopyable.h"
-#include "util/singleton.h"
 #include "util/semaphore_lockable.h"
+#include "util/singleton.h"
+#include "util/timer/timer.h"
 #include <atomic>
+#include <chrono>
+#include <freertos/FreeRTOS.h>
 #include <mutex>
-#include <optional>
-#include <vector>
 
+/**
+ * Settings are read from RAM, so getters are cheap enough for the render path.
+ * Changes take effect immediately and are written to NVS once no further
+ * change came in for a while, so a burst of button presses costs a single
+ * flash write. All settings are stored together as one blob, see settings_schema.h.
+ */
 class config : public esp32::singleton<config>
 {
   public:
     void begin();
+
+    /**
+     * Writes pending changes to NVS now.
+     */
     void save();
 
-    uint8_t get_screen_brightness();
-    void set_screen_brightness(uint8_t screen_brightness);
+    template <typename T> T get(const settings_schema::field<T> &field) const
+    {
+        taskENTER_CRITICAL(&values_lock_);
+        const T value = values_.*field.member;
+        taskEXIT_CRITICAL(&values_lock_);
+        return value;
+    }
+
+    /**
+     * Sets the value, clamped to the range of the setting.
+     */
+    template <typename T> void set(const settings_schema::field<T> &field, T value)
+    {
+        taskENTER_CRITICAL(&values_lock_);
+        values_.*field.member = field.clamp(value);
+        taskEXIT_CRITICAL(&values_lock_);
+        changed();
+    }
 
   private:
     config() = default;
@@ -25,4 +54,18 @@ class config : public esp32::singleton<config>
 
     mutable esp32::semaphore data_mutex_;
     preferences nvs_storage_;
+
+    settings_schema::values values_{settings_schema::defaults()};
+    mutable portMUX_TYPE values_lock_ = portMUX_INITIALIZER_UNLOCKED;
+    std::atomic<bool> dirty_{false};
+
+    const std::chrono::seconds commit_delay_{2};
+    esp32::timer::timer commit_timer_{commit_timer_fired, this, "config_commit"};
+    app_event_subscriber instance_commit_event_{CONFIG_COMMIT_DUE, commit_due, this};
+
+    settings_schema::values snapshot() const;
+    void migrate_from_keys();
+    void changed();
+    static void commit_timer_fired(void *);
+    static void commit_due(void *context, int32_t);
 };
@@ -1,13 +1,24 @@
 #include "preferences.h"
 
+preferences::name_buffer preferences::to_name(const std::string_view &name)
+{
+    name_buffer buffer{};
+    if (name.size() >= buffer.size())
+    {
+        CHECK_THROW_ESP2(ESP_ERR_NVS_KEY_TOO_LONG, "Name too long");
+    }
+    std::copy(name.begin(), name.end(), buffer.begin());
+    return buffer;
+}
+
 void preferences::begin(const std::string_view &part_name, const std::string_view &namespace_name)
 {
     if (started_)
     {
         CHECK_THROW_ESP2(ESP_FAIL, "Already started");
     }
-    CHECK_THROW_ESP(nvs_flash_init_partition(part_name.data()));
-    CHECK_THROW_ESP(nvs_open_from_partition(part_name.data(), namespace_name.data(), NVS_READWRITE, &handle_));
+    CHECK_THROW_ESP(nvs_flash_init_partition(to_name(part_name).data()));
+    CHECK_THROW_ESP(nvs_open_from_partition(to_name(part_name).data(), to_name(namespace_name).data(), NVS_READWRITE, &handle_));
     started_ = true;
 }
 
@@ -27,12 +38,12 @@ void preferences::commit()
 
 void preferences::save(const std::string_view &key, bool value)
 {
-    CHECK_THROW_ESP(nvs_set_u8(handle_, key.data(), value));
+    CHECK_THROW_ESP(nvs_set_u8(handle_, to_name(key).data(), value));
 }
 
 void preferences::save(const std::string_view &key, uint8_t value)
 {
-    CHECK_THROW_ESP(nvs_set_u8(handle_, key.data(), value));
+    CHECK_THROW_ESP(nvs_set_u8(handle_, to_name(key).data(), value));
 }
 
 bool preferences::get(const std::string_view &key, bool default_value)
@@ -44,7 +55,7 @@ bool preferences::get(const std::string_view &key, bool default_value)
 uint8_t preferences::get(const std::string_view &key, uint8_t default_value)
 {
     uint8_t value{};
-    const auto err = nvs_get_u8(handle_, key.data(), &value);
+    const auto err = nvs_get_u8(handle_, to_name(key).data(), &value);
     if (err == ESP_ERR_NVS_NOT_FOUND)
     {
         return default_value;
@@ -55,18 +66,18 @@ uint8_t preferences::get(const std::string_view &key, uint8_t default_value)
 
 void preferences::save(const std::string_view &key, const std::string_view &value)
 {
-    CHECK_THROW_ESP(nvs_set_str(handle_, key.data(), value.data()));
+    save(key, std::string(value));
 }
 
 void preferences::save(const std::string_view &key, const std::string &value)
 {
-    CHECK_THROW_ESP(nvs_set_str(handle_, key.data(), value.data()));
+    CHECK_THROW_ESP(nvs_set_str(handle_, to_name(key).data(), value.data()));
 }
 
 std::string preferences::get(const std::string_view &key, const std::string_view &default_value)
 {
     size_t length{};
-    const auto err = nvs_get_str(handle_, key.data(), NULL, &length);
+    const auto err = nvs_get_str(handle_, to_name(key).data(), NULL, &length);
     if (err == ESP_ERR_NVS_NOT_FOUND)
     {
         return std::string(default_value);
@@ -74,7 +85,46 @@ std::string preferences::get(const std::string_view &key, const std::string_view
     CHECK_THROW_ESP(err);
     std::string data;
     data.resize(length);
-    CHECK_THROW_ESP(nvs_get_str(handle_, key.data(), data.data(), &length));
+    CHECK_THROW_ESP(nvs_get_str(handle_, to_name(key).data(), data.data(), &length));
     data.resize(length - 1); // length includes zero ending
     return data;
 }
+
+void preferences::save_blob(const std::string_view &key, std::span<const uint8_t> value)
+{
+    CHECK_THROW_ESP(nvs_set_blob(handle_, to_name(key).data(), value.data(), value.size()));
+}
+
+std::optional<size_t> preferences::get_blob(const std::string_view &key, std::span<uint8_t> data)
+{
+    const auto name = to_name(key);
+    size_t length{};
+    auto err = nvs_get_blob(handle_, name.data(), NULL, &length);
+    if (err == ESP_ERR_NVS_NOT_FOUND)
+    {
+        return std::nullopt;
+    }
+    CHECK_THROW_ESP(err);
+
+    if (length <= data.size())
+    {
+        CHECK_THROW_ESP(nvs_get_blob(handle_, name.data(), data.data(), &length));
+    }
+    else
+    {
+        // stored by a newer version with more settings, the known prefix is still read
+        std::string stored(length, '\0');
+        CHECK_THROW_ESP(nvs_get_blob(handle_, name.data(), stored.data(), &length));
+        std::copy_n(stored.begin(), data.size(), data.begin());
+    }
+    return length;
+}
+
+void preferences::erase(const std::string_view &key)
+{
+    const auto err = nvs_erase_key(handle_, to_name(key).data());
+    if (err != ESP_ERR_NVS_NOT_FOUND)
+    {
+        CHECK_THROW_ESP(err);
+    }
+}
@@ -2,8 +2,11 @@
 
 #include "util/exceptions.h"
 #include "util/noncopyable.h"
+#include <array>
 #include <nvs.h>
 #include <nvs_flash.h>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -29,7 +32,19 @@ class preferences : esp32::noncopyable
     uint8_t get(const std::string_view &key, uint8_t default_value);
     std::string get(const std::string_view &key, const std::string_view &default_value);
 
+    void save_blob(const std::string_view &key, std::span<const uint8_t> value);
+    /**
+     * Reads up to data.size() bytes, returns the stored size or nothing if the key does not exist.
+     */
+    std::optional<size_t> get_blob(const std::string_view &key, std::span<uint8_t> data);
+
+    void erase(const std::string_view &key);
+
   private:
+    // NVS takes null terminated names, a string_view need not be
+    using name_buffer = std::array<char, NVS_KEY_NAME_MAX_SIZE>;
+    static name_buffer to_name(const std::string_view &name);
+
     uint32_t handle_{};
     bool started_{false};
 };
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <span>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+/**
+ * All persisted settings, with their defaults and valid ranges.
+ *
+ * The values are stored as one blob: a version byte followed by the fields
+ * in schema order, each in its native size. New settings are appended to
+ * the end, so an older blob still loads and the new settings keep their
+ * defaults. The version only changes if the meaning of stored bytes changes.
+ *
+ * Has no dependency on NVS or FreeRTOS so it can be compiled for the host.
+ */
+namespace settings_schema
+{
+enum class fade_curve_t : uint8_t
+{
+    linear,
+    perceptual,
+};
+
+typedef struct values
+{
+    uint8_t screen_brightness;
+    bool volume_bar;
+    uint8_t display_off_timeout_s;
+    uint16_t fade_interval_ms;
+    fade_curve_t fade_curve;
+} values;
+
+template <typename T> struct field
+{
+    using value_type = T;
+
+    T values::*member;
+    T default_value;
+    T min;
+    T max;
+
+    constexpr T clamp(T value) const
+    {
+        return std::clamp(value, min, max);
+    }
+};
+
+inline constexpr field<uint8_t> screen_brightness{&values::screen_brightness, 8, 0, 15};
+inline constexpr field<bool> volume_bar{&values::volume_bar, false, false, true};
+inline constexpr field<uint8_t> display_off_timeout_s{&values::display_off_timeout_s, 5, 1, 120};
+// time between two fade steps. The fade used to take one 120 ms step per brightness level, about 1 s from the
+// default brightness 8; fade_curve has 32 steps, so 40 ms keeps a full fade at about the same 1.3 s
+inline constexpr field<uint16_t> fade_interval_ms{&values::fade_interval_ms, 40, 10, 500};
+inline constexpr field<fade_curve_t> fade_curve{&values::fade_curve, fade_curve_t::perceptual, fade_curve_t::linear, fade_curve_t::perceptual};
+
+// in blob order, only ever append
+inline constexpr auto fields = std::make_tuple(screen_brightness, volume_bar, display_off_timeout_s, fade_interval_ms, fade_curve);
+
+inline constexpr uint8_t version = 1;
+
+inline constexpr size_t blob_size = std::apply([](auto &&...field) { return 1 + (sizeof(typename std::decay_t<decltype(field)>::value_type) + ...); }, fields);
+
+constexpr values defaults()
+{
+    values result{};
+    std::apply([&result](auto &&...field) { ((result.*field.member = field.default_value), ...); }, fields);
+    return result;
+}
+
+inline std::array<uint8_t, blob_size> serialize(const values &value)
+{
+    std::array<uint8_t, blob_size> blob{};
+    blob[0] = version;
+    size_t offset = 1;
+    std::apply(
+        [&](auto &&...field) {
+            ((memcpy(&blob[offset], &(value.*field.member), sizeof(value.*field.member)), offset += sizeof(value.*field.member)), ...);
+        },
+        fields);
+    return blob;
+}
+
+/**
+ * Returns the settings stored in the blob, fields missing from a shorter
+ * blob get their defaults and stored values are clamped to their range.
+ * A bool stored as anything but 0 or 1 gets its default too.
+ * Returns nothing for a blob from an unknown version.
+ */
+inline std::optional<values> deserialize(std::span<const uint8_t> blob)
+{
+    if (blob.empty() || blob[0] != version)
+    {
+        return std::nullopt;
+    }
+
+    auto result = defaults();
+    size_t offset = 1;
+    std::apply(
+        [&](auto &&...field) {
+            (
+                [&] {
+                    using T = typename std::decay_t<decltype(field)>::value_type;
+                    if (offset + sizeof(T) <= blob.size())
+                    {
+                        if constexpr (std::is_same_v<T, bool>)
+                        {
+                            // any other byte than 0 or 1 is not a valid bool, the default stays
+                            if (blob[offset] <= 1)
+                            {
+                                result.*field.member = blob[offset] == 1;
+                            }
+                        }
+                        else
+                        {
+                            T stored;
+                            memcpy(&stored, &blob[offset], sizeof(T));
+                            result.*field.member = field.clamp(stored);
+                        }
+                    }
+                    offset += sizeof(T);
+                }(),
+                ...);
+        },
+        fields);
+    return result;
+}
+} // namespace settings_schema
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "frame_buffer.h"
+#include <array>
+#include <stdint.h>
+
+enum class blend_op : uint8_t
+{
+    // layer pixels replace what is below, inside the layer columns only
+    replace,
+    // lit pixels of the layer are added
+    over,
+    // only pixels lit in both stay lit
+    mask,
+    // lit pixels of the layer toggle what is below
+    toggle,
+};
+
+/**
+ * Stacks a fixed set of frame layers from the base upwards into the frame that gets sent to the display.
+ */
+class compositor
+{
+  public:
+    enum class layer_id : uint8_t
+    {
+        base,
+        bar,
+        overlay,
+        count,
+    };
+
+    constexpr static uint32_t all_columns = 0xffffffff;
+
+    constexpr void set(layer_id id, const frame_buffer &image, blend_op op = blend_op::over, uint32_t columns = all_columns)
+    {
+        layers_[static_cast<size_t>(id)] = layer{image, op, columns, true};
+    }
+
+    constexpr void clear(layer_id id)
+    {
+        layers_[static_cast<size_t>(id)].visible = false;
+    }
+
+    constexpr void clear_all()
+    {
+        for (auto &layer : layers_)
+        {
+            layer.visible = false;
+        }
+    }
+
+    constexpr frame_buffer compose() const
+    {
+        frame_buffer frame;
+        for (auto &&layer : layers_)
+        {
+            if (layer.visible)
+            {
+                blend(frame, layer.image, layer.op, layer.columns);
+            }
+        }
+        return frame;
+    }
+
+    static constexpr void blend(frame_buffer &target, const frame_buffer &image, blend_op op, uint32_t columns = all_columns)
+    {
+        const auto in_columns = frame_buffer::column_mask(columns);
+        auto source = image;
+        source &= in_columns;
+        switch (op)
+        {
+        case blend_op::replace:
+            target &= ~in_columns;
+            target |= source;
+            break;
+        case blend_op::over:
+            target |= source;
+            break;
+        case blend_op::mask:
+            // columns outside the layer are left as they are
+            source |= ~in_columns;
+            target &= source;
+            break;
+        case blend_op::toggle:
+            target ^= source;
+            break;
+        }
+    }
+
+  private:
+    struct layer
+    {
+        frame_buffer image;
+        blend_op op;
+        uint32_t columns;
+        bool visible;
+    };
+
+    std::array<layer, static_cast<size_t>(layer_id::count)> layers_{};
+};
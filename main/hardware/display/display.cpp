@@ -1,8 +1,12 @@
 #include "display.h"
+#include "feedback_decoder.h"
 #include "logging/logging_tags.h"
+#include "screens.h"
+#include "text_renderer.h"
 #include "util/cores.h"
-#include "util/default_event.h"
 #include "util/exceptions.h"
+#include "util/latency_stats.h"
+#include <cinttypes>
 #include <driver/spi_master.h>
 #include <esp_log.h>
 #include <util/helper.h>
@@ -11,11 +15,11 @@ constexpr static int MOSI_PIN = 21;
 constexpr static int CLK_PIN = 18;
 constexpr static gpio_num_t CS_PIN = GPIO_NUM_19;
 constexpr static spi_host_device_t HOST = SPI3_HOST;
-constexpr static int CASCADE_SIZE = 4;
 
 void display::begin()
 {
     instance_app_common_event_.subscribe();
+    instance_avr_state_event_.subscribe();
 
     ESP_LOGI(DISPLAY_TAG, "Initializing SPI BUS");
     spi_bus_config_t cfg = {.mosi_io_num = MOSI_PIN,
@@ -57,233 +61,378 @@ void display::begin()
     button_ = iot_button_create(&gpio_btn_cfg);
 
     CHECK_THROW_ESP(iot_button_register_cb(button_, BUTTON_SINGLE_CLICK, button_event_callback<&display::button_click>, this));
+    CHECK_THROW_ESP(iot_button_register_cb(button_, BUTTON_LONG_PRESS_START, button_event_callback<&display::button_long_press>, this));
+    initialized_ = true;
 }
 
-void display::start_display(const std::array<const void *, 4> &values, bool turn_off)
+void display::start_display(bool turn_off)
 {
     set_default_brightness();
-    set_max7219_display(values);
+    set_max7219_display(compositor_.compose());
     if (turn_off)
     {
         restart_display_off_timer();
     }
 }
 
+void display::schedule_render()
+{
+    if (render_pending_)
+    {
+        // the deferred render picks up this state as well
+        return;
+    }
+
+    const auto now = esp32::timer::get_time();
+    const auto next_render_time = last_render_time_ + std::chrono::microseconds(min_render_interval_us_.load());
+    if (now >= next_render_time)
+    {
+        render();
+    }
+    else
+    {
+        render_pending_ = true;
+        render_timer_.start_one_shot(next_render_time - now);
+    }
+}
+
+void display::render()
+{
+    const auto sequence = state_sequence_.load();
+    const auto posted_at = std::chrono::microseconds(last_state_posted_at_.load());
+    const auto received_at = std::chrono::microseconds(last_state_received_at_.load());
+
+    update_display_based_on_display_value();
+
+    last_render_time_ = esp32::timer::get_time();
+    const auto input_to_photon = (last_render_time_ - posted_at).count();
+    if (sequence - last_rendered_sequence_ > 1)
+    {
+        dropped_states_ += sequence - last_rendered_sequence_ - 1;
+    }
+    last_rendered_sequence_ = sequence;
+    rendered_frames_++;
+    last_input_to_photon_us_ = input_to_photon;
+    if (input_to_photon > max_input_to_photon_us_.load())
+    {
+        max_input_to_photon_us_ = input_to_photon;
+    }
+    if (received_at.count())
+    {
+        latency_stats::record(latency_stats::stage::dispatch_to_spi, last_render_time_ - posted_at);
+        latency_stats::record(latency_stats::stage::end_to_end, last_render_time_ - received_at);
+    }
+    ESP_LOGD(DISPLAY_TAG, "Rendered in %lld us after input", input_to_photon);
+}
+
+display::render_stats display::get_render_stats() const
+{
+    return render_stats{
+        .rendered_frames = rendered_frames_.load(),
+        .dropped_states = dropped_states_.load(),
+        .last_input_to_photon = std::chrono::microseconds(last_input_to_photon_us_.load()),
+        .max_input_to_photon = std::chrono::microseconds(max_input_to_photon_us_.load()),
+    };
+}
+
+void display::set_max_frame_rate(uint8_t frames_per_second)
+{
+    configASSERT(frames_per_second);
+    min_render_interval_us_ = 1000 * 1000 / frames_per_second;
+}
+
 void display::update_display_based_on_display_value()
 {
     const auto current_display_value = display_value_.load();
-    display_fade_timer_.reset();
+    display_fade_timer_.stop_if_active();
+    animation_timer_.stop_if_active();
+    animation_ = animation::none;
+    compositor_.clear_all();
     if (std::holds_alternative<None>(current_display_value))
     {
         // start a fade timer
-        display_off_timer_.reset();
+        display_off_timer_.stop_if_active();
         ESP_LOGI(DISPLAY_TAG, "Clearing display with fading");
-        display_fade_timer_ =
-            std::make_unique<esp32::timer::timer>([this] { xTaskNotify(gui_task_.handle(), fade_display_bit, eSetBits); }, "display_fade_timer");
-        display_fade_timer_->start_periodic(fade_interval_delay_);
+        fade_start_brightness_ = current_brightness_;
+        fade_step_ = 0;
+        display_fade_timer_.start_periodic(fade_interval_);
     }
     else if (std::holds_alternative<ScreenBrightnessLevel>(current_display_value))
     {
-        constexpr static uint64_t all_on = 0xffffffffffffffff;
-        constexpr std::array<const void *, 4> display_values{
-            &all_on,
-            &all_on,
-            &all_on,
-            &all_on,
-        };
-
-        start_display(display_values, true);
+        compositor_.set(layer::base, screens::all_on);
+        start_display(true);
     }
     else if (std::holds_alternative<FourChars>(current_display_value))
     {
         auto &&four_chars = std::get<FourChars>(current_display_value);
         ESP_LOGI(DISPLAY_TAG, "Setting display to %s", reinterpret_cast<const char *>(four_chars.value.data()));
-        const auto display_values = get_display_led_bits(four_chars.value);
-        start_display(display_values, true);
+        compositor_.set(layer::base, screens::four_chars(four_chars.value));
+        start_display(true);
+    }
+    else if (std::holds_alternative<Volume>(current_display_value))
+    {
+        auto &&volume = std::get<Volume>(current_display_value);
+        ESP_LOGI(DISPLAY_TAG, "Setting volume to %d half dB", volume.half_db);
+        show_volume(volume.half_db);
+    }
+    else if (std::holds_alternative<Text>(current_display_value))
+    {
+        auto &&text = std::get<Text>(current_display_value);
+        ESP_LOGI(DISPLAY_TAG, "Setting display to %.*s", text.value.length, text.value.data.data());
+        show_text(text.value.view());
     }
     else if (std::holds_alternative<MuteOn>(current_display_value))
     {
         ESP_LOGI(DISPLAY_TAG, "Setting Mute On");
-
-        constexpr static uint64_t muteon_led_bits[] = {
-            0x636363636b7f7763,
-            0x3f333333b3000000,
-            0xc646c646df060606,
-            0xfbc8cbfac3c0c0c0,
-        };
-        constexpr std::array<const void *, 4> display_values{
-            &muteon_led_bits[0],
-            &muteon_led_bits[1],
-            &muteon_led_bits[2],
-            &muteon_led_bits[3],
-        };
-
-        start_display(display_values, false);
+        compositor_.set(layer::base, screens::mute_on);
+        start_display(false);
     }
     else if (std::holds_alternative<PowerOff>(current_display_value))
     {
         ESP_LOGI(DISPLAY_TAG, "Setting Poweroff");
-
-        constexpr static uint64_t bits[] = {
-            0xc0606060606060c0,
-            0x636666e6e66666e3,
-            0x606060e3e36060e7,
-            0x0000000303000007,
-        };
-        constexpr std::array<const void *, 4> display_values{
-            &bits[0],
-            &bits[1],
-            &bits[2],
-            &bits[3],
-        };
-
-        start_display(display_values, true);
+        compositor_.set(layer::base, screens::power_off);
+        start_display(true);
     }
     else if (std::holds_alternative<DynVol>(current_display_value))
     {
-        // condensed "DynVol"
-        constexpr static uint64_t dyn_vol_led_bits[] = {
-            0xe789e9a9a9090907,
-            0xcaca2a2a2e202020,
-            0x5c55555d41414141,
-        };
-
-        constexpr static uint64_t dyn_vol_level_led_bits[] = {
-            0x3c42858991a1423c,
-            0x3c3cff7e3c180000,
-            0x3c3c3cff7e3c1800,
-            0x3c3c3c3cff7e3c18,
-        };
-
         auto &&dyn_vol = std::get<DynVol>(current_display_value);
         ESP_LOGI(DISPLAY_TAG, "Setting Dynamic Volume:%d", dyn_vol.value);
-
-        std::array<const void *, 4> display_values{
-            &dyn_vol_led_bits[0],
-            &dyn_vol_led_bits[1],
-            &dyn_vol_led_bits[2],
-            &dyn_vol_level_led_bits[dyn_vol.value],
-        };
-
-        start_display(display_values, true);
+        compositor_.set(layer::base, screens::dyn_vol_label);
+        compositor_.set(layer::overlay, screens::dyn_vol_levels[dyn_vol.value], blend_op::replace, screens::dyn_vol_level_columns);
+        start_display(true);
     }
 }
 
-std::array<const void *, 4U> display::get_display_led_bits(const std::array<uint8_t, 4> &values)
+void display::show_text(std::string_view text)
 {
-    std::array<const void *, 4U> display_values;
-    size_t index = 0;
-    for (auto &&c : values)
+    text_width_ = text_renderer::render(text, text_columns_);
+    scroll_offset_ = 0;
+    set_default_brightness();
+
+    if (text_width_ <= frame_buffer::width)
     {
-        display_values[index] = get_display_led_bits(c);
-        index++;
+        frame_buffer frame;
+        frame.blit(std::span<const uint8_t>(text_columns_.data(), text_width_), (frame_buffer::width - text_width_) / 2);
+        compositor_.set(layer::base, frame);
+        set_max7219_display(compositor_.compose());
+        restart_display_off_timer();
+    }
+    else
+    {
+        // stays on until scrolled to the end
+        display_off_timer_.stop_if_active();
+        scroll_hold_ticks_ = scroll_start_hold_ticks;
+        draw_text_window();
+        animation_ = animation::scroll_text;
+        animation_timer_.start_periodic(scroll_interval_);
     }
-    return display_values;
 }
 
-const void *display::get_display_led_bits(uint8_t c)
+void display::animate()
 {
-    // https://xantorohara.github.io/led-matrix-editor/
-    constexpr static std::array<uint64_t, 10> digits_led_bits = {
-        0x3c6666666666663c, // 0
-        0x7e181818181e1c18, // 1
-        0x7e66063c6066667c, // 2
-        0x3c6666303066663c, // 3
-        0x3030307e36363636, // 4
-        0x3c6666603e06667e, // 5
-        0x3c66663e0666663c, // 6
-        0x0c0c18383060667e, // 7
-        0x3c66663c3c66663c, // 8
-        0x3c6666607e66663c, // 9
-    };
-
-    constexpr static std::array<uint64_t, 26> letters_capital_led_bits = {
-        0x6666667e66667e3c, // A
-        0x3e66663e3e66663e, // B
-        0x3c6606060606663c, // C
-        0x3e6666666666663e, // D
-        0x7e06063e3e06067e, // E
-        0x0606063e3e06067e, // F
-        0x3c6666760646663c, // G
-        0x6666667e7e666666, // H
-        0x3c1818181818183c, // I
-        0x1c36363030303078, // J
-        0x66361e0e0e1e3666, // K
-        0x7e06060606060606, // L
-        0xc6c6c6c6d6feeec6, // M
-        0xc6e6f6fedecec6c6, // N
-        0x3c6666666666663c, // O
-        0x06063e7e6666663e, // P
-        0x603c76666666663c, // Q
-        0x66361e3e6666663e, // R
-        0x3c66703c0e06663c, // S
-        0x1818181818185a7e, // T
-        0x7c66666666666666, // U
-        0x183c666666666666, // V
-        0xc6eefed6c6c6c6c6, // W
-        0xc6c6ee386ceec6c6, // X
-        0x1818183c7e666666, // Y
-        0x7e060c183060607e, // Z
-    };
-
-    constexpr static std::array<uint64_t, 26> letters_small_led_bits = {
-        0x7c667c603c000000, 0x3e66663e06060606, 0x3c6606663c000000, 0x7c66667c60606060, 0x3c067e663c000000, 0x0c0c0c3e0c6c6c38, 0x3c607c66667c0000,
-        0x6666663e06060606, 0x3c18181800181800, 0x1c36363030003030, 0x66361e3666660606, 0x1818181818181818, 0xd6d6feeec6000000, 0x6666667e3e000000,
-        0x3c6666663c000000, 0x06063e66663e0000, 0xf0b03c36363c0000, 0x060666663e000000, 0x3e403c027c000000, 0x181818187e181818, 0x7c66666666000000,
-        0x183c666666000000, 0x7cd6d6d6c6000000, 0x663c183c66000000, 0x3c607c6666000000, 0x3c0c18303c000000};
+    // late notification after the animation was stopped
+    if (!animation_timer_.is_active())
+    {
+        return;
+    }
 
-    constexpr static uint64_t plus_small_led_bits = {
-        0x0018187e7e181800,
-    };
+    switch (animation_)
+    {
+    case animation::scroll_text:
+        scroll_text();
+        break;
+    case animation::volume_bar:
+        step_volume_bar();
+        break;
+    case animation::none:
+        break;
+    }
+}
 
-    constexpr static uint64_t zero = 0;
+void display::scroll_text()
+{
+    if (scroll_hold_ticks_)
+    {
+        scroll_hold_ticks_--;
+        return;
+    }
 
-    if (c >= '0' && c <= '9')
+    scroll_offset_++;
+    draw_text_window();
+    if (scroll_offset_ + frame_buffer::width >= text_width_)
     {
-        return &digits_led_bits[c - '0'];
+        animation_timer_.stop_if_active();
+        restart_display_off_timer();
     }
-    else if (c <= 'Z' && c >= 'A')
+}
+
+void display::show_volume(uint8_t half_db)
+{
+    if (!config_.get(settings_schema::volume_bar))
     {
-        return &letters_capital_led_bits[c - 'A'];
+        compositor_.set(layer::base, screens::volume_digits(half_db));
+        start_display(true);
+        return;
     }
-    else if (c <= 'z' && c >= 'a')
+
+    const auto max_half_db = max_volume_half_db_.load();
+    if (max_half_db != volume_bar_max_half_db_)
     {
-        return &letters_small_led_bits[c - 'a'];
+        volume_bar_.set_max(max_half_db);
+        volume_bar_max_half_db_ = max_half_db;
     }
-    else if (c == '+')
+
+    // animates from wherever the bar was last drawn
+    volume_bar_target_ = volume_bar_.position(half_db);
+    set_default_brightness();
+    draw_volume_bar();
+    if (volume_bar_position_ == volume_bar_target_)
     {
-        return &plus_small_led_bits;
+        restart_display_off_timer();
     }
     else
     {
-        return &zero;
+        display_off_timer_.stop_if_active();
+        animation_ = animation::volume_bar;
+        animation_timer_.start_periodic(volume_bar_frame_interval_);
+    }
+}
+
+void display::step_volume_bar()
+{
+    // eases out, covering a quarter of the remaining distance per frame
+    const int distance = volume_bar_target_ - volume_bar_position_;
+    const int step = distance / 4 ? distance / 4 : (distance > 0 ? 1 : -1);
+    volume_bar_position_ += step;
+    draw_volume_bar();
+
+    if (volume_bar_position_ == volume_bar_target_)
+    {
+        animation_timer_.stop_if_active();
+        restart_display_off_timer();
     }
 }
 
-void display::set_max7219_display(const std::array<const void *, 4> &values)
+void display::draw_volume_bar()
 {
-    CHECK_THROW_ESP(max7219_draw_image_8x8(&handle_, 0, values[0]));
-    CHECK_THROW_ESP(max7219_draw_image_8x8(&handle_, 8, values[1]));
-    CHECK_THROW_ESP(max7219_draw_image_8x8(&handle_, 16, values[2]));
-    CHECK_THROW_ESP(max7219_draw_image_8x8(&handle_, 24, values[3]));
+    compositor_.set(layer::bar, volume_bar::frame(volume_bar_position_));
+    set_max7219_display(compositor_.compose());
 }
 
-void display::restart_display_off_timer()
+void display::draw_text_window()
 {
-    if (display_off_timer_)
+    frame_buffer frame;
+    frame.blit(std::span<const uint8_t>(text_columns_.data(), text_width_), -static_cast<int>(scroll_offset_));
+    compositor_.set(layer::base, frame);
+    set_max7219_display(compositor_.compose());
+}
+
+void display::set_max7219_display(const frame_buffer &frame)
+{
+    const auto start = esp32::timer::get_time();
+    const auto bytes_before = spi_bytes_sent_.load();
+    const auto module_rows = frame.to_module_rows();
+
+    // rows with the same index on every module go out in one transaction,
+    // modules whose row did not change get a no-op
+    for (uint8_t row = 0; row < ROWS_PER_MODULE; row++)
     {
-        display_off_timer_->restart(display_off_timeout_);
+        std::array<uint8_t, CASCADE_SIZE> row_values;
+        uint8_t changed_modules = 0;
+        for (uint8_t module = 0; module < CASCADE_SIZE; module++)
+        {
+            row_values[module] = static_cast<uint8_t>(module_rows[module] >> (row * 8));
+            if (row_values[module] != shadow_frame_[module][row])
+            {
+                changed_modules |= BIT(module);
+            }
+        }
+
+        if (changed_modules)
+        {
+            write_max7219_row(row, row_values, changed_modules);
+        }
     }
-    else
+
+    ESP_LOGD(DISPLAY_TAG, "Display updated with %" PRIu32 " bytes in %lld us", spi_bytes_sent_.load() - bytes_before,
+             (esp32::timer::get_time() - start).count());
+    ESP_LOGV(DISPLAY_TAG, "Frame:\n%s", frame.to_ascii().data());
+}
+
+void display::write_max7219_row(uint8_t row, const std::array<uint8_t, CASCADE_SIZE> &row_values, uint8_t changed_modules)
+{
+    // same register layout as the max7219 driver: one 16 bit word per chip,
+    // register in the first byte, an all zero word is a no-op
+    constexpr uint8_t REG_DIGIT_0 = 1;
+    std::array<uint8_t, CASCADE_SIZE * 2> buffer{};
+    for (uint8_t module = 0; module < CASCADE_SIZE; module++)
     {
-        display_off_timer_ = std::make_unique<esp32::timer::timer>([this] { set_display_value(None()); }, "display_off_timer");
-        display_off_timer_->start_one_shot(display_off_timeout_);
+        if (!(changed_modules & BIT(module)))
+        {
+            continue;
+        }
+
+        uint8_t digit = module * ROWS_PER_MODULE + row;
+        if (handle_.mirrored)
+        {
+            digit = handle_.digits - digit - 1;
+        }
+        const auto chip = digit / ROWS_PER_MODULE;
+        buffer[chip * 2] = REG_DIGIT_0 + digit % ROWS_PER_MODULE;
+        buffer[chip * 2 + 1] = row_values[module];
+    }
+
+    spi_transaction_t transaction{};
+    transaction.length = buffer.size() * 8;
+    transaction.tx_buffer = buffer.data();
+    CHECK_THROW_ESP(spi_device_transmit(handle_.spi_dev, &transaction));
+    spi_bytes_sent_ += buffer.size();
+
+    for (uint8_t module = 0; module < CASCADE_SIZE; module++)
+    {
+        if (changed_modules & BIT(module))
+        {
+            shadow_frame_[module][row] = row_values[module];
+        }
     }
 }
 
+void display::clear_max7219()
+{
+    CHECK_THROW_ESP(max7219_clear(&handle_));
+    // the driver writes every digit with its own transaction
+    spi_bytes_sent_ += handle_.digits * CASCADE_SIZE * 2;
+    shadow_frame_ = {};
+}
+
+void display::restart_display_off_timer()
+{
+    display_off_timer_.restart_one_shot(display_off_timeout_);
+}
+
+void display::display_off_timer_fired()
+{
+    set_display_value(None());
+}
+
+void display::display_fade_timer_fired()
+{
+    xTaskNotify(gui_task_.handle(), fade_display_bit, eSetBits);
+}
+
+void display::render_timer_fired()
+{
+    xTaskNotify(gui_task_.handle(), render_deferred_bit, eSetBits);
+}
+
+void display::animation_timer_fired()
+{
+    xTaskNotify(gui_task_.handle(), animation_bit, eSetBits);
+}
+
 void display::set_default_brightness()
 {
-    const auto default_brightness = config_.get_screen_brightness();
+    const auto default_brightness = config_.get(settings_schema::screen_brightness);
     if (current_brightness_ != default_brightness)
     {
         set_max7219_brightness(default_brightness);
@@ -302,8 +451,9 @@ void display::gui_task()
 
     try
     {
+        apply_timing_config();
         set_default_brightness();
-        CHECK_THROW_ESP(max7219_clear(&handle_));
+        clear_max7219();
 
         do
         {
@@ -313,34 +463,56 @@ void display::gui_task()
                             &notification_value, /* Stores the notified value. */
                             portMAX_DELAY);
 
+            if (notification_value & config_changed_display_bit)
+            {
+                apply_timing_config();
+            }
+
+            // several bits can arrive in one wake up and all of them are cleared, so each one is handled
             if (notification_value & button_clicked_display_bit)
             {
-                const auto current = config_.get_screen_brightness();
+                const auto current = config_.get(settings_schema::screen_brightness);
                 const auto new_value = (current + 1) % 16;
-                config_.set_screen_brightness(new_value);
+                config_.set(settings_schema::screen_brightness, static_cast<uint8_t>(new_value));
                 ESP_LOGI(DISPLAY_TAG, "Setting screen brightness to %d", new_value);
                 set_display_value(ScreenBrightnessLevel(new_value));
-                update_display_based_on_display_value();
-            }
-            else if (notification_value & set_display_changed_bit)
-            {
-                update_display_based_on_display_value();
             }
-            else if (notification_value & fade_display_bit)
+
+            if (notification_value & button_long_pressed_display_bit)
             {
-                if (current_brightness_ <= 1)
-                {
-                    display_fade_timer_.reset();
-                    ESP_LOGI(DISPLAY_TAG, "Display off");
-                    CHECK_THROW_ESP(max7219_clear(&handle_));
-                }
-                else
+                const auto volume_bar = !config_.get(settings_schema::volume_bar);
+                config_.set(settings_schema::volume_bar, volume_bar);
+                ESP_LOGI(DISPLAY_TAG, "Volume bar %s", volume_bar ? "on" : "off");
+
+                // redraw the volume in the new mode if it is showing
+                const auto current_display_value = display_value_.load();
+                if (std::holds_alternative<Volume>(current_display_value))
                 {
-                    current_brightness_--;
-                    set_max7219_brightness(current_brightness_);
+                    set_display_value(current_display_value);
                 }
             }
 
+            if (notification_value & render_deferred_bit)
+            {
+                render_pending_ = false;
+                render();
+            }
+
+            // a render that just ran already shows the changed value
+            if ((notification_value & set_display_changed_bit) && !(notification_value & render_deferred_bit))
+            {
+                schedule_render();
+            }
+
+            if (notification_value & animation_bit)
+            {
+                animate();
+            }
+
+            if (notification_value & fade_display_bit)
+            {
+                fade_display();
+            }
         } while (true);
     }
     catch (const std::exception &ex)
@@ -353,91 +525,60 @@ void display::gui_task()
     vTaskDelete(NULL);
 }
 
-void display::app_event_handler(esp_event_base_t, int32_t event, void *data)
+void display::app_event_handler(int32_t event)
 {
     switch (event)
     {
     case APP_INIT_DONE:
         break;
-    case NEW_FEEDBACK_RECEIVED: {
-        const auto feedback_string = denon_avr_.get_last_feedback();
+    case CONFIG_CHANGE:
+        xTaskNotify(gui_task_.handle(), config_changed_display_bit, eSetBits);
+        break;
+    }
+}
 
-        if (feedback_string.empty())
-        {
-            set_display_value(None());
-            break;
-        }
+void display::apply_timing_config()
+{
+    display_off_timeout_ = std::chrono::seconds(config_.get(settings_schema::display_off_timeout_s));
+    fade_interval_ = std::chrono::milliseconds(config_.get(settings_schema::fade_interval_ms));
+    fade_curve_ = config_.get(settings_schema::fade_curve);
 
-        constexpr static std::string_view mute_on_command("MUON");
-        constexpr static std::string_view mute_off_command("MUOFF");
-        constexpr static std::string_view volume_prefix_command("MV");
-        constexpr static std::string_view dynvol_prefix_command("PSDYNVOL");
-        constexpr static std::string_view off_prefix_command("PWSTANDBY");
-        constexpr static std::string_view on_prefix_command("PWON");
-        if (feedback_string == mute_on_command)
-        {
-            set_display_value(MuteOn());
-        }
-        else if (feedback_string == mute_off_command)
-        {
-            set_display_value(None());
-        }
-        else if (feedback_string == off_prefix_command)
-        {
-            set_display_value(PowerOff());
-        }
-        else if (feedback_string == on_prefix_command)
-        {
-            set_display_value(FourChars({' ', 'O', 'N', ' '}));
-        }
-        else if (feedback_string.starts_with(volume_prefix_command))
-        {
-            constexpr static std::string_view volume_max_prefix_command("MVMAX");
-            if (!feedback_string.starts_with(volume_max_prefix_command))
-            {
-                const auto volume_string = feedback_string.substr(volume_prefix_command.size());
+    // running timers take the new values over, a periodic timer keeps running with the new period
+    display_off_timer_.restart_if_active(display_off_timeout_);
+    display_fade_timer_.restart_if_active(fade_interval_);
+}
 
-                if ((volume_string.size() == 3) && (volume_string[2] == '5'))
-                {
-                    set_display_value(FourChars({' ', volume_string[0], volume_string[1], '+'}));
-                }
-                else
-                {
-                    set_display_value(FourChars({' ', volume_string[0], volume_string[1], ' '}));
-                }
-            }
-        }
-        else if (feedback_string.starts_with(dynvol_prefix_command))
-        {
-            const auto dynvol_string = feedback_string.substr(dynvol_prefix_command.size() + 1);
-
-            constexpr static std::string_view off_command("OFF");
-            constexpr static std::string_view light_command("LIT");
-            constexpr static std::string_view med_command("MED");
-            constexpr static std::string_view hev_command("HEV");
-            uint8_t value = 0;
-            if (off_command == dynvol_string)
-            {
-                value = 0;
-            }
-            else if (light_command == dynvol_string)
-            {
-                value = 1;
-            }
-            else if (med_command == dynvol_string)
-            {
-                value = 2;
-            }
-            else if (hev_command == dynvol_string)
-            {
-                value = 3;
-            }
+void display::fade_display()
+{
+    fade_step_++;
+    const auto brightness = fade_curve::brightness_at(fade_curve_, fade_start_brightness_, fade_step_);
+    if (!brightness.has_value())
+    {
+        display_fade_timer_.stop_if_active();
+        ESP_LOGI(DISPLAY_TAG, "Display off");
+        clear_max7219();
+        volume_bar_position_ = 0;
+    }
+    else if (*brightness != current_brightness_)
+    {
+        set_max7219_brightness(*brightness);
+    }
+}
 
-            set_display_value(DynVol(value));
-        }
+void display::avr_state_changed(const avr_state_update &update)
+{
+    latency_stats::record(latency_stats::stage::frame_to_dispatch, esp32::timer::get_time() - std::chrono::microseconds(update.framed_at_us));
 
-        break;
+    const auto &delta = update.delta;
+    if (auto max_volume = std::get_if<avr_state::max_volume_t>(&delta))
+    {
+        max_volume_half_db_ = max_volume->half_db;
     }
+
+    const auto value = feedback_decoder::decode(delta);
+    if (value.has_value())
+    {
+        set_display_value(*value, std::chrono::microseconds(update.received_at_us));
     }
 }
 
@@ -445,4 +586,10 @@ void display::button_click()
 {
     ESP_LOGI(DISPLAY_TAG, "Button clicked");
     xTaskNotify(gui_task_.handle(), button_clicked_display_bit, eSetBits);
+}
+
+void display::button_long_press()
+{
+    ESP_LOGI(DISPLAY_TAG, "Button long pressed");
+    xTaskNotify(gui_task_.handle(), button_long_pressed_display_bit, eSetBits);
 }
\ No newline at end of file
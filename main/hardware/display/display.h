@@ -1,13 +1,17 @@
 #pragma once
 
 #include "app_events.h"
+#include "compositor.h"
 #include "config/config_manager.h"
-#include "hardware/uart/denon_avr.h"
-#include "util/default_event.h"
+#include "display_value.h"
+#include "fade_curve.h"
+#include "frame_buffer.h"
+#include "hardware/uart/avr_state.h"
 #include "util/semaphore_lockable.h"
 #include "util/singleton.h"
 #include "util/task_wrapper.h"
 #include "util/timer/timer.h"
+#include "volume_bar.h"
 #include <iot_button.h>
 #include <max7219.h>
 #include <variant>
@@ -17,73 +21,170 @@ class display final : public esp32::singleton<display>
   public:
     void begin();
 
-    template <typename T> void set_display_value(T &&value)
+    /**
+     * Whether begin() completed, i.e. the SPI bus, the LED modules and the gui task are up.
+     */
+    bool is_initialized() const
+    {
+        return initialized_.load();
+    }
+
+    /**
+     * Total bytes clocked out to the LED modules since boot.
+     */
+    uint32_t get_spi_bytes_sent() const
+    {
+        return spi_bytes_sent_.load();
+    }
+
+    /**
+     * received_at is when the feedback behind the value arrived on the uart, if it came from there.
+     */
+    template <typename T> void set_display_value(T &&value, std::chrono::microseconds received_at = {})
     {
         display_value_.store(std::forward<T>(value));
+        last_state_received_at_.store(received_at.count());
+        last_state_posted_at_.store(esp32::timer::get_time().count());
+        state_sequence_++;
         xTaskNotify(gui_task_.handle(), set_display_changed_bit, eSetBits);
     }
 
+    typedef struct render_stats
+    {
+        uint32_t rendered_frames;
+        // states replaced by a newer one before they were rendered
+        uint32_t dropped_states;
+        std::chrono::microseconds last_input_to_photon;
+        std::chrono::microseconds max_input_to_photon;
+    } render_stats;
+
+    render_stats get_render_stats() const;
+
+    /**
+     * Limits how often the display is redrawn, states arriving faster are coalesced and only the newest is shown.
+     */
+    void set_max_frame_rate(uint8_t frames_per_second);
+
   private:
-    display(config &config, denon_avr &denon_avr) : config_(config), denon_avr_(denon_avr), gui_task_([this] { display::gui_task(); })
+    display(config &config) : config_(config), gui_task_([this] { display::gui_task(); })
     {
     }
 
     friend class esp32::singleton<display>;
 
     config &config_;
-    denon_avr &denon_avr_;
     esp32::task gui_task_;
     max7219_t handle_{};
 
-    typedef struct None
-    {
-        uint8_t value;
-    } None;
-    typedef struct FourChars
-    {
-        std::array<uint8_t, 4> value;
-    } FourChars;
-    typedef struct MuteOn
-    {
-    } MuteOn;
-    typedef struct DynVol
-    {
-        uint8_t value;
-    } DynVol;
-    typedef struct PowerOff
-    {
-    } PowerOff;
-    typedef struct ScreenBrightnessLevel
+    using None = display_state::None;
+    using FourChars = display_state::FourChars;
+    using MuteOn = display_state::MuteOn;
+    using DynVol = display_state::DynVol;
+    using PowerOff = display_state::PowerOff;
+    using ScreenBrightnessLevel = display_state::ScreenBrightnessLevel;
+    using Text = display_state::Text;
+    using Volume = display_state::Volume;
+
+    std::atomic<display_state::value> display_value_{None()};
+
+    // every screen is composed from these layers, only touched by the gui task
+    using layer = compositor::layer_id;
+    compositor compositor_;
+
+    esp32::timer::timer display_off_timer_{timer_callback<&display::display_off_timer_fired>, this, "display_off_timer"};
+    esp32::timer::timer display_fade_timer_{timer_callback<&display::display_fade_timer_fired>, this, "display_fade_timer"};
+    esp32::timer::timer render_timer_{timer_callback<&display::render_timer_fired>, this, "render_timer"};
+    // drives whichever animation the current screen has, at most one runs at a time
+    esp32::timer::timer animation_timer_{timer_callback<&display::animation_timer_fired>, this, "animation_timer"};
+
+    enum class animation : uint8_t
     {
-        uint8_t value;
-    } ScreenBrightnessLevel;
+        none,
+        scroll_text,
+        volume_bar,
+    };
+    animation animation_{animation::none};
+
+    // text rendered with the proportional font, scrolled through the panel if wider than it
+    std::array<uint8_t, 192> text_columns_{};
+    size_t text_width_{0};
+    size_t scroll_offset_{0};
+    uint8_t scroll_hold_ticks_{0};
+
+    // volume bar, positions in eighths of a column
+    volume_bar volume_bar_;
+    std::atomic<uint8_t> max_volume_half_db_{volume_bar::default_max_half_db};
+    uint8_t volume_bar_max_half_db_{volume_bar::default_max_half_db};
+    uint16_t volume_bar_position_{0};
+    uint16_t volume_bar_target_{0};
+
+    // render scheduler, all but the atomics are only touched by the gui task
+    std::atomic<uint32_t> min_render_interval_us_{1000 * 1000 / 25};
+    std::atomic<uint32_t> state_sequence_{0};
+    std::atomic<int64_t> last_state_posted_at_{0};
+    std::atomic<int64_t> last_state_received_at_{0};
+    uint32_t last_rendered_sequence_{0};
+    std::chrono::microseconds last_render_time_{0};
+    bool render_pending_{false};
+    std::atomic<bool> initialized_{false};
+    std::atomic<uint32_t> rendered_frames_{0};
+    std::atomic<uint32_t> dropped_states_{0};
+    std::atomic<int64_t> last_input_to_photon_us_{0};
+    std::atomic<int64_t> max_input_to_photon_us_{0};
 
-    // one of these state
-    std::atomic<std::variant<None, FourChars, MuteOn, DynVol, PowerOff, ScreenBrightnessLevel>> display_value_{None()};
+    constexpr static uint8_t CASCADE_SIZE = 4;
+    constexpr static uint8_t ROWS_PER_MODULE = 8;
 
-    std::unique_ptr<esp32::timer::timer> display_off_timer_;
-    std::unique_ptr<esp32::timer::timer> display_fade_timer_;
+    // rows as last sent to each module, updates only send what differs
+    std::array<std::array<uint8_t, ROWS_PER_MODULE>, CASCADE_SIZE> shadow_frame_{};
+    std::atomic<uint32_t> spi_bytes_sent_{0};
 
     uint8_t current_brightness_{0};
     button_handle_t button_;
 
-    const std::chrono::seconds display_off_timeout_{5};
-    const std::chrono::milliseconds fade_interval_delay_{120};
+    // from config, reloaded on the gui task when it changes
+    std::chrono::seconds display_off_timeout_{settings_schema::display_off_timeout_s.default_value};
+    std::chrono::milliseconds fade_interval_{settings_schema::fade_interval_ms.default_value};
+    settings_schema::fade_curve_t fade_curve_{settings_schema::fade_curve.default_value};
+    uint8_t fade_start_brightness_{0};
+    uint8_t fade_step_{0};
 
-    esp32::default_event_subscriber instance_app_common_event_{
-        APP_COMMON_EVENT, ESP_EVENT_ANY_ID, [this](esp_event_base_t base, int32_t event, void *data) { app_event_handler(base, event, data); }};
+    const std::chrono::milliseconds scroll_interval_{40};
+    const std::chrono::milliseconds volume_bar_frame_interval_{20};
+    constexpr static uint8_t scroll_start_hold_ticks = 20;
+
+    app_event_subscriber instance_app_common_event_{app_event_bus::any_event, app_event_callback, this};
+    app_event_subscriber_typed<avr_state_update> instance_avr_state_event_{AVR_STATE_CHANGED, avr_state_callback, this};
 
     void gui_task();
-    void app_event_handler(esp_event_base_t, int32_t, void *);
+    void app_event_handler(int32_t event);
+    void avr_state_changed(const avr_state_update &update);
     void update_display_based_on_display_value();
-    std::array<const void *, 4U> get_display_led_bits(const std::array<uint8_t, 4> &fourChars);
-    const void *get_display_led_bits(uint8_t c);
+    void schedule_render();
+    void render();
     void restart_display_off_timer();
     void set_default_brightness();
     void set_max7219_brightness(uint8_t value);
-    void set_max7219_display(const std::array<const void *, 4> &values);
-    void start_display(const std::array<const void *, 4> &values, bool turn_off);
+    void set_max7219_display(const frame_buffer &frame);
+    void show_text(std::string_view text);
+    void scroll_text();
+    void show_volume(uint8_t half_db);
+    void step_volume_bar();
+    void draw_volume_bar();
+    void animate();
+    void draw_text_window();
+    void write_max7219_row(uint8_t row, const std::array<uint8_t, CASCADE_SIZE> &row_values, uint8_t changed_modules);
+    void clear_max7219();
+    void start_display(bool turn_off);
     void button_click();
+    void button_long_press();
+    void apply_timing_config();
+    void fade_display();
+
+    void display_off_timer_fired();
+    void display_fade_timer_fired();
+    void render_timer_fired();
+    void animation_timer_fired();
 
     template <void (display::*ftn)()> static void button_event_callback(void *, void *usr_data)
     {
@@ -91,7 +192,27 @@ class display final : public esp32::singleton<display>
         (p_this->*ftn)();
     }
 
+    template <void (display::*ftn)()> static void timer_callback(void *arg)
+    {
+        auto p_this = reinterpret_cast<display *>(arg);
+        (p_this->*ftn)();
+    }
+
+    static void app_event_callback(void *arg, int32_t event)
+    {
+        reinterpret_cast<display *>(arg)->app_event_handler(event);
+    }
+
+    static void avr_state_callback(void *arg, int32_t, const avr_state_update &update)
+    {
+        reinterpret_cast<display *>(arg)->avr_state_changed(update);
+    }
+
     constexpr static uint32_t set_display_changed_bit = BIT(2);
     constexpr static uint32_t fade_display_bit = BIT(3);
     constexpr static uint32_t button_clicked_display_bit = BIT(4);
+    constexpr static uint32_t render_deferred_bit = BIT(5);
+    constexpr static uint32_t animation_bit = BIT(6);
+    constexpr static uint32_t button_long_pressed_display_bit = BIT(7);
+    constexpr static uint32_t config_changed_display_bit = BIT(8);
 };
\ No newline at end of file
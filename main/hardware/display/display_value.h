@@ -0,0 +1,43 @@
+#pragma once
+
+#include "util/fixed_string.h"
+#include <array>
+#include <stdint.h>
+#include <variant>
+
+namespace display_state
+{
+typedef struct None
+{
+    uint8_t value;
+} None;
+typedef struct FourChars
+{
+    std::array<uint8_t, 4> value;
+} FourChars;
+typedef struct MuteOn
+{
+} MuteOn;
+typedef struct DynVol
+{
+    uint8_t value;
+} DynVol;
+typedef struct PowerOff
+{
+} PowerOff;
+typedef struct ScreenBrightnessLevel
+{
+    uint8_t value;
+} ScreenBrightnessLevel;
+typedef struct Volume
+{
+    uint8_t half_db;
+} Volume;
+typedef struct Text
+{
+    fixed_string<24> value;
+} Text;
+
+// one of these state
+using value = std::variant<None, FourChars, MuteOn, DynVol, PowerOff, ScreenBrightnessLevel, Volume, Text>;
+} // namespace display_state
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "config/settings_schema.h"
+#include <array>
+#include <optional>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Brightness over the course of a fade out, as a fraction of the starting
+ * brightness scaled to 255, one entry per fade step.
+ */
+namespace fade_curve
+{
+constexpr size_t steps = 32;
+
+// (1 - step / steps) ^ 2.2, the perceived brightness falls evenly
+inline constexpr std::array<uint8_t, steps> perceptual = {
+    255, 238, 221, 205, 190, 175, 161, 148, 135, 123, 112, 101, 91, 81, 72, 63,
+    55,  48,  41,  35,  29,  24,  20,  16,  12,  9,   6,   4,   3,  1,  1,  0,
+};
+
+// 1 - step / steps, the LED duty cycle falls evenly, which looks like a late drop
+inline constexpr std::array<uint8_t, steps> linear = {
+    255, 247, 239, 231, 223, 215, 207, 199, 191, 183, 175, 167, 159, 151, 143, 135,
+    128, 120, 112, 104, 96,  88,  80,  72,  64,  56,  48,  40,  32,  24,  16,  8,
+};
+
+constexpr const std::array<uint8_t, steps> &table(settings_schema::fade_curve_t curve)
+{
+    return curve == settings_schema::fade_curve_t::linear ? linear : perceptual;
+}
+
+/**
+ * Brightness at the given step of a fade starting at start_brightness, nothing once the fade is complete.
+ */
+constexpr std::optional<uint8_t> brightness_at(settings_schema::fade_curve_t curve, uint8_t start_brightness, size_t step)
+{
+    if (step >= steps)
+    {
+        return std::nullopt;
+    }
+    // the lowest max7219 intensity is still lit, so intensity i stands for i + 1 steps of duty cycle
+    const auto level = ((start_brightness + 1) * table(curve)[step] + 127) / 255;
+    if (level == 0)
+    {
+        return std::nullopt;
+    }
+    return static_cast<uint8_t>(level - 1);
+}
+} // namespace fade_curve
@@ -0,0 +1,56 @@
+#include "feedback_decoder.h"
+
+using namespace display_state;
+
+namespace
+{
+using decode_result = std::optional<display_state::value>;
+
+decode_result decode(avr_state::power_t power)
+{
+    if (power == avr_state::power_t::standby)
+    {
+        return PowerOff();
+    }
+    return FourChars({' ', 'O', 'N', ' '});
+}
+
+decode_result decode(const avr_state::mute_t &mute)
+{
+    if (mute.on)
+    {
+        return MuteOn();
+    }
+    return None();
+}
+
+decode_result decode(const avr_state::volume_t &volume)
+{
+    return Volume(volume.half_db);
+}
+
+decode_result decode(avr_state::dynamic_volume_t dynamic_volume)
+{
+    return DynVol(static_cast<uint8_t>(dynamic_volume));
+}
+
+decode_result decode(const avr_state::input_source_t &input_source)
+{
+    return Text(fixed_string<24>::from(input_source.name.view()));
+}
+
+decode_result decode(const avr_state::surround_mode_t &surround_mode)
+{
+    return Text(fixed_string<24>::from(surround_mode.name.view()));
+}
+
+decode_result decode(const auto &)
+{
+    return std::nullopt;
+}
+} // namespace
+
+std::optional<display_state::value> feedback_decoder::decode(const avr_state_delta &delta)
+{
+    return std::visit([](auto &&value) { return ::decode(value); }, delta);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "display_value.h"
+#include "hardware/uart/avr_state.h"
+#include <optional>
+
+/**
+ * Maps AVR state updates to display states.
+ * Has no dependency on the hardware or FreeRTOS so it can be compiled for the host.
+ */
+class feedback_decoder
+{
+  public:
+    /**
+     * Returns the state to display for the update, or nothing if the update does not change the display.
+     */
+    static std::optional<display_state::value> decode(const avr_state_delta &delta);
+};
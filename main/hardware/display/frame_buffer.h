@@ -0,0 +1,285 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * 32x8 pixel frame for the four cascaded 8x8 modules, stored column-major.
+ *
+ * Each module is one 64 bit word, byte k of word m is column 8m+k from the
+ * left and bit r of a column byte is row r from the top. The max7219 takes
+ * rows instead, so a frame is transposed per module when it is sent.
+ */
+class frame_buffer
+{
+  public:
+    constexpr static size_t width = 32;
+    constexpr static size_t height = 8;
+    constexpr static size_t module_count = width / 8;
+
+    constexpr uint8_t column(size_t x) const
+    {
+        return static_cast<uint8_t>(modules_[x / 8] >> ((x % 8) * 8));
+    }
+
+    constexpr void set_column(size_t x, uint8_t bits)
+    {
+        const auto shift = (x % 8) * 8;
+        auto &module = modules_[x / 8];
+        module = (module & ~(uint64_t{0xff} << shift)) | (uint64_t{bits} << shift);
+    }
+
+    constexpr void clear()
+    {
+        modules_ = {};
+    }
+
+    /**
+     * Copies columns into the frame with the first one at x, columns falling outside the frame are clipped.
+     */
+    constexpr void blit(std::span<const uint8_t> columns, int x)
+    {
+        for (size_t i = 0; i < columns.size(); i++)
+        {
+            const auto target = x + static_cast<int>(i);
+            if (target >= 0 && target < static_cast<int>(width))
+            {
+                set_column(target, columns[i]);
+            }
+        }
+    }
+
+    /**
+     * Returns the 8x8 row images for the modules, as used by the max7219.
+     */
+    constexpr std::array<uint64_t, module_count> to_module_rows() const
+    {
+        std::array<uint64_t, module_count> rows{};
+        for (size_t m = 0; m < module_count; m++)
+        {
+            rows[m] = transpose8(modules_[m]);
+        }
+        return rows;
+    }
+
+    static constexpr frame_buffer from_module_rows(const std::array<uint64_t, module_count> &rows)
+    {
+        frame_buffer frame;
+        for (size_t m = 0; m < module_count; m++)
+        {
+            frame.modules_[m] = transpose8(rows[m]);
+        }
+        return frame;
+    }
+
+    constexpr bool operator==(const frame_buffer &) const = default;
+
+    constexpr frame_buffer &operator|=(const frame_buffer &other)
+    {
+        for (size_t m = 0; m < module_count; m++)
+        {
+            modules_[m] |= other.modules_[m];
+        }
+        return *this;
+    }
+
+    constexpr frame_buffer &operator&=(const frame_buffer &other)
+    {
+        for (size_t m = 0; m < module_count; m++)
+        {
+            modules_[m] &= other.modules_[m];
+        }
+        return *this;
+    }
+
+    constexpr frame_buffer &operator^=(const frame_buffer &other)
+    {
+        for (size_t m = 0; m < module_count; m++)
+        {
+            modules_[m] ^= other.modules_[m];
+        }
+        return *this;
+    }
+
+    constexpr frame_buffer operator~() const
+    {
+        frame_buffer frame;
+        for (size_t m = 0; m < module_count; m++)
+        {
+            frame.modules_[m] = ~modules_[m];
+        }
+        return frame;
+    }
+
+    /**
+     * Returns a frame with all pixels of the columns set in the mask lit, bit x is column x.
+     */
+    static constexpr frame_buffer column_mask(uint32_t columns)
+    {
+        frame_buffer frame;
+        for (size_t x = 0; x < width; x++)
+        {
+            if (columns & (uint32_t{1} << x))
+            {
+                frame.set_column(x, 0xff);
+            }
+        }
+        return frame;
+    }
+
+    /**
+     * Moves the image n columns to the right, or to the left if negative. Columns shifted in are blank.
+     *
+     * The modules form one 256 bit little endian word with column x at bit 8x, so this is a multi word shift.
+     */
+    constexpr void shift_columns(int n)
+    {
+        if (n >= static_cast<int>(width) || n <= -static_cast<int>(width))
+        {
+            clear();
+            return;
+        }
+
+        const size_t bits = (n < 0 ? -n : n) * 8;
+        const size_t word_shift = bits / 64;
+        const size_t bit_shift = bits % 64;
+        std::array<uint64_t, module_count> result{};
+        for (size_t m = 0; m < module_count; m++)
+        {
+            if (n > 0)
+            {
+                if (m < word_shift)
+                {
+                    continue;
+                }
+                const auto source = m - word_shift;
+                result[m] = modules_[source] << bit_shift;
+                if (bit_shift && source > 0)
+                {
+                    result[m] |= modules_[source - 1] >> (64 - bit_shift);
+                }
+            }
+            else
+            {
+                const auto source = m + word_shift;
+                if (source >= module_count)
+                {
+                    continue;
+                }
+                result[m] = modules_[source] >> bit_shift;
+                if (bit_shift && source + 1 < module_count)
+                {
+                    result[m] |= modules_[source + 1] << (64 - bit_shift);
+                }
+            }
+        }
+        modules_ = result;
+    }
+
+    /**
+     * Moves the image n rows down, or up if negative. Rows shifted in are blank.
+     */
+    constexpr void shift_rows(int n)
+    {
+        if (n >= static_cast<int>(height) || n <= -static_cast<int>(height))
+        {
+            clear();
+            return;
+        }
+
+        // every byte is a column, shift all eight at once and drop what crossed into the next byte
+        for (auto &module : modules_)
+        {
+            if (n > 0)
+            {
+                module = (module << n) & (broadcast(static_cast<uint8_t>(0xff << n)));
+            }
+            else if (n < 0)
+            {
+                module = (module >> -n) & (broadcast(static_cast<uint8_t>(0xff >> -n)));
+            }
+        }
+    }
+
+    /**
+     * Mirrors the image left to right.
+     */
+    constexpr void mirror()
+    {
+        std::array<uint64_t, module_count> result{};
+        for (size_t m = 0; m < module_count; m++)
+        {
+            result[module_count - m - 1] = reverse_bytes(modules_[m]);
+        }
+        modules_ = result;
+    }
+
+    /**
+     * Mirrors the image top to bottom.
+     */
+    constexpr void flip()
+    {
+        for (auto &module : modules_)
+        {
+            module = reverse_bits_in_bytes(module);
+        }
+    }
+
+    /**
+     * Renders the frame as text, '#' for lit pixels and '.' for dark ones, one line per row.
+     * Meant for logs and for comparing frames against expected images off target.
+     */
+    constexpr std::array<char, (width + 1) * height + 1> to_ascii() const
+    {
+        std::array<char, (width + 1) * height + 1> text{};
+        size_t i = 0;
+        for (size_t y = 0; y < height; y++)
+        {
+            for (size_t x = 0; x < width; x++)
+            {
+                text[i++] = (column(x) & (1 << y)) ? '#' : '.';
+            }
+            text[i++] = '\n';
+        }
+        text[i] = '\0';
+        return text;
+    }
+
+    /**
+     * Transposes an 8x8 bit matrix held one byte per line, i.e. bit 8i+j moves to bit 8j+i.
+     */
+    static constexpr uint64_t transpose8(uint64_t x)
+    {
+        uint64_t t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+        x = x ^ t ^ (t << 7);
+        t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+        x = x ^ t ^ (t << 14);
+        t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+        x = x ^ t ^ (t << 28);
+        return x;
+    }
+
+  private:
+    std::array<uint64_t, module_count> modules_{};
+
+    static constexpr uint64_t broadcast(uint8_t value)
+    {
+        return value * 0x0101010101010101ULL;
+    }
+
+    static constexpr uint64_t reverse_bytes(uint64_t x)
+    {
+        x = ((x & 0x00FF00FF00FF00FFULL) << 8) | ((x >> 8) & 0x00FF00FF00FF00FFULL);
+        x = ((x & 0x0000FFFF0000FFFFULL) << 16) | ((x >> 16) & 0x0000FFFF0000FFFFULL);
+        return (x << 32) | (x >> 32);
+    }
+
+    static constexpr uint64_t reverse_bits_in_bytes(uint64_t x)
+    {
+        x = ((x & 0x5555555555555555ULL) << 1) | ((x >> 1) & 0x5555555555555555ULL);
+        x = ((x & 0x3333333333333333ULL) << 2) | ((x >> 2) & 0x3333333333333333ULL);
+        return ((x & 0x0F0F0F0F0F0F0F0FULL) << 4) | ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL);
+    }
+};
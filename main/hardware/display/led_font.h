@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <stdint.h>
+
+// 8x8 tiles, one byte per row from the top, bit 0 is the leftmost column
+namespace led_font
+{
+// https://xantorohara.github.io/led-matrix-editor/
+inline constexpr std::array<uint64_t, 10> digits_led_bits = {
+    0x3c6666666666663c, // 0
+    0x7e181818181e1c18, // 1
+    0x7e66063c6066667c, // 2
+    0x3c6666303066663c, // 3
+    0x3030307e36363636, // 4
+    0x3c6666603e06667e, // 5
+    0x3c66663e0666663c, // 6
+    0x0c0c18383060667e, // 7
+    0x3c66663c3c66663c, // 8
+    0x3c6666607e66663c, // 9
+};
+
+inline constexpr std::array<uint64_t, 26> letters_capital_led_bits = {
+    0x6666667e66667e3c, // A
+    0x3e66663e3e66663e, // B
+    0x3c6606060606663c, // C
+    0x3e6666666666663e, // D
+    0x7e06063e3e06067e, // E
+    0x0606063e3e06067e, // F
+    0x3c6666760646663c, // G
+    0x6666667e7e666666, // H
+    0x3c1818181818183c, // I
+    0x1c36363030303078, // J
+    0x66361e0e0e1e3666, // K
+    0x7e06060606060606, // L
+    0xc6c6c6c6d6feeec6, // M
+    0xc6e6f6fedecec6c6, // N
+    0x3c6666666666663c, // O
+    0x06063e7e6666663e, // P
+    0x603c76666666663c, // Q
+    0x66361e3e6666663e, // R
+    0x3c66703c0e06663c, // S
+    0x1818181818185a7e, // T
+    0x7c66666666666666, // U
+    0x183c666666666666, // V
+    0xc6eefed6c6c6c6c6, // W
+    0xc6c6ee386ceec6c6, // X
+    0x1818183c7e666666, // Y
+    0x7e060c183060607e, // Z
+};
+
+inline constexpr std::array<uint64_t, 26> letters_small_led_bits = {
+    0x7c667c603c000000, 0x3e66663e06060606, 0x3c6606663c000000, 0x7c66667c60606060, 0x3c067e663c000000, 0x0c0c0c3e0c6c6c38, 0x3c607c66667c0000,
+    0x6666663e06060606, 0x3c18181800181800, 0x1c36363030003030, 0x66361e3666660606, 0x1818181818181818, 0xd6d6feeec6000000, 0x6666667e3e000000,
+    0x3c6666663c000000, 0x06063e66663e0000, 0xf0b03c36363c0000, 0x060666663e000000, 0x3e403c027c000000, 0x181818187e181818, 0x7c66666666000000,
+    0x183c666666000000, 0x7cd6d6d6c6000000, 0x663c183c66000000, 0x3c607c6666000000, 0x3c0c18303c000000};
+
+inline constexpr uint64_t plus_small_led_bits = 0x0018187e7e181800;
+inline constexpr uint64_t slash_led_bits = 0x0002040810204000;
+inline constexpr uint64_t dot_led_bits = 0x1818000000000000;
+inline constexpr uint64_t minus_led_bits = 0x0000007e7e000000;
+inline constexpr uint64_t colon_led_bits = 0x0018180000181800;
+inline constexpr uint64_t blank_led_bits = 0;
+
+/**
+ * Returns the tile for the character, a blank tile if there is none.
+ */
+constexpr const uint64_t &tile(uint8_t c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return digits_led_bits[c - '0'];
+    }
+    else if (c <= 'Z' && c >= 'A')
+    {
+        return letters_capital_led_bits[c - 'A'];
+    }
+    else if (c <= 'z' && c >= 'a')
+    {
+        return letters_small_led_bits[c - 'a'];
+    }
+
+    switch (c)
+    {
+    case '+':
+        return plus_small_led_bits;
+    case '/':
+        return slash_led_bits;
+    case '.':
+        return dot_led_bits;
+    case '-':
+        return minus_led_bits;
+    case ':':
+        return colon_led_bits;
+    default:
+        return blank_led_bits;
+    }
+}
+} // namespace led_font
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "frame_buffer.h"
+#include "led_font.h"
+#include <array>
+#include <stdint.h>
+
+// fixed screens, drawn as 8x8 row images per module from the left
+namespace screens
+{
+inline constexpr auto all_on = frame_buffer::from_module_rows({
+    0xffffffffffffffff,
+    0xffffffffffffffff,
+    0xffffffffffffffff,
+    0xffffffffffffffff,
+});
+
+inline constexpr auto mute_on = frame_buffer::from_module_rows({
+    0x636363636b7f7763,
+    0x3f333333b3000000,
+    0xc646c646df060606,
+    0xfbc8cbfac3c0c0c0,
+});
+
+inline constexpr auto power_off = frame_buffer::from_module_rows({
+    0xc0606060606060c0,
+    0x636666e6e66666e3,
+    0x606060e3e36060e7,
+    0x0000000303000007,
+});
+
+// condensed "DynVol", the last module is left for the level
+inline constexpr auto dyn_vol_label = frame_buffer::from_module_rows({
+    0xe789e9a9a9090907,
+    0xcaca2a2a2e202020,
+    0x5c55555d41414141,
+    0,
+});
+
+inline constexpr uint32_t dyn_vol_level_columns = 0xff000000;
+
+inline constexpr std::array<frame_buffer, 4> dyn_vol_levels = {
+    frame_buffer::from_module_rows({0, 0, 0, 0x3c42858991a1423c}),
+    frame_buffer::from_module_rows({0, 0, 0, 0x3c3cff7e3c180000}),
+    frame_buffer::from_module_rows({0, 0, 0, 0x3c3c3cff7e3c1800}),
+    frame_buffer::from_module_rows({0, 0, 0, 0x3c3c3c3cff7e3c18}),
+};
+
+/**
+ * Four tiles of the fixed width font side by side.
+ */
+constexpr frame_buffer four_chars(const std::array<uint8_t, 4> &chars)
+{
+    return frame_buffer::from_module_rows({
+        led_font::tile(chars[0]),
+        led_font::tile(chars[1]),
+        led_font::tile(chars[2]),
+        led_font::tile(chars[3]),
+    });
+}
+
+/**
+ * Volume as two digits, followed by a '+' for the half dB step.
+ */
+constexpr frame_buffer volume_digits(uint8_t half_db)
+{
+    const auto whole = half_db / 2;
+    const auto tens = static_cast<uint8_t>('0' + (whole / 10) % 10);
+    const auto units = static_cast<uint8_t>('0' + whole % 10);
+    return four_chars({' ', tens, units, static_cast<uint8_t>(half_db % 2 ? '+' : ' ')});
+}
+} // namespace screens
@@ -0,0 +1,141 @@
+#include "text_renderer.h"
+#include "frame_buffer.h"
+#include "led_font.h"
+#include <algorithm>
+#include <array>
+
+namespace
+{
+typedef struct glyph
+{
+    uint16_t offset;
+    uint8_t width;
+} glyph;
+
+constexpr uint8_t first_char = ' ';
+constexpr uint8_t last_char = '~';
+constexpr size_t glyph_count = last_char - first_char + 1;
+constexpr uint8_t space_width = 3;
+constexpr uint8_t glyph_spacing = 1;
+
+// columns of the 8x8 tile with the empty ones on both sides trimmed away
+struct trimmed_tile
+{
+    std::array<uint8_t, 8> columns;
+    uint8_t first;
+    uint8_t width;
+};
+
+constexpr trimmed_tile trim_tile(uint8_t c)
+{
+    const auto transposed = frame_buffer::transpose8(led_font::tile(c));
+    trimmed_tile tile{};
+    uint8_t last = 0;
+    bool found = false;
+    for (uint8_t x = 0; x < 8; x++)
+    {
+        tile.columns[x] = static_cast<uint8_t>(transposed >> (x * 8));
+        if (tile.columns[x])
+        {
+            if (!found)
+            {
+                tile.first = x;
+                found = true;
+            }
+            last = x;
+        }
+    }
+    tile.width = found ? last - tile.first + 1 : 0;
+    return tile;
+}
+
+constexpr size_t packed_size()
+{
+    size_t size = 0;
+    for (size_t c = first_char; c <= last_char; c++)
+    {
+        size += trim_tile(c).width;
+    }
+    return size;
+}
+
+// all glyphs packed back to back, generated at compile time from the 8x8 tiles
+struct glyph_atlas
+{
+    std::array<glyph, glyph_count> glyphs;
+    std::array<uint8_t, packed_size()> columns;
+};
+
+constexpr glyph_atlas build_atlas()
+{
+    glyph_atlas atlas{};
+    uint16_t offset = 0;
+    for (size_t c = first_char; c <= last_char; c++)
+    {
+        const auto tile = trim_tile(c);
+        atlas.glyphs[c - first_char] = {offset, tile.width};
+        for (uint8_t x = 0; x < tile.width; x++)
+        {
+            atlas.columns[offset++] = tile.columns[tile.first + x];
+        }
+    }
+    return atlas;
+}
+
+constexpr glyph_atlas atlas = build_atlas();
+
+// characters outside the atlas get an empty glyph and are skipped
+constexpr glyph get_glyph(char c)
+{
+    const auto value = static_cast<uint8_t>(c);
+    if (value < first_char || value > last_char)
+    {
+        return glyph{0, 0};
+    }
+    return atlas.glyphs[value - first_char];
+}
+
+// places glyphs left to right, calls draw(glyph, x) for each, returns the width up to the end of the last glyph
+template <typename F> size_t layout(std::string_view text, size_t max_width, F &&draw)
+{
+    size_t x = 0;
+    size_t used = 0;
+    for (auto &&c : text)
+    {
+        if (c == ' ')
+        {
+            x += space_width;
+            continue;
+        }
+
+        const auto g = get_glyph(c);
+        if (!g.width)
+        {
+            continue;
+        }
+        if (x + g.width > max_width)
+        {
+            break;
+        }
+
+        draw(g, used, x);
+        x += g.width;
+        used = x;
+        x += glyph_spacing;
+    }
+    return used;
+}
+} // namespace
+
+size_t text_renderer::render(std::string_view text, std::span<uint8_t> columns)
+{
+    return layout(text, columns.size(), [&columns](const glyph &g, size_t previous_end, size_t x) {
+        std::fill(columns.begin() + previous_end, columns.begin() + x, 0);
+        std::copy_n(atlas.columns.begin() + g.offset, g.width, columns.begin() + x);
+    });
+}
+
+size_t text_renderer::width(std::string_view text)
+{
+    return layout(text, SIZE_MAX, [](const glyph &, size_t, size_t) {});
+}
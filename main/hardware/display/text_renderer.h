@@ -0,0 +1,26 @@
+#pragma once
+
+#include <span>
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+
+/**
+ * Renders text with the proportional font into display columns.
+ * Has no dependency on the hardware or FreeRTOS so it can be compiled for the host.
+ */
+class text_renderer
+{
+  public:
+    /**
+     * Renders text into columns (bit r is row r from the top), returns the number of columns used.
+     * Only columns up to that width are written.
+     * Text that does not fit is cut at the last glyph that fits.
+     */
+    static size_t render(std::string_view text, std::span<uint8_t> columns);
+
+    /**
+     * Returns the number of columns render would use for text, trailing spaces are not counted.
+     */
+    static size_t width(std::string_view text);
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "frame_buffer.h"
+#include <algorithm>
+#include <array>
+#include <stdint.h>
+
+/**
+ * Maps the Denon volume scale onto a bar filling the panel from the left.
+ *
+ * Bar positions are in eighths of a column, the partially filled column
+ * grows from the bottom row, so each half dB step moves the bar visibly even
+ * though the scale has more steps than the panel has columns.
+ */
+class volume_bar
+{
+  public:
+    constexpr static uint8_t steps_per_column = frame_buffer::height;
+    constexpr static uint16_t full_position = frame_buffer::width * steps_per_column;
+
+    // MV98, the top of the Denon scale
+    constexpr static uint8_t default_max_half_db = 196;
+
+    constexpr volume_bar()
+    {
+        set_max(default_max_half_db);
+    }
+
+    /**
+     * Rescales the table so that max is a full bar, as reported by MVMAX.
+     */
+    constexpr void set_max(uint8_t max_half_db)
+    {
+        max_half_db = std::max<uint8_t>(max_half_db, 1);
+        for (size_t half_db = 0; half_db < positions_.size(); half_db++)
+        {
+            positions_[half_db] = static_cast<uint16_t>(std::min<size_t>(half_db, max_half_db) * full_position / max_half_db);
+        }
+    }
+
+    constexpr uint16_t position(uint8_t half_db) const
+    {
+        return positions_[half_db];
+    }
+
+    static constexpr frame_buffer frame(uint16_t position)
+    {
+        position = std::min(position, full_position);
+        const size_t full_columns = position / steps_per_column;
+
+        frame_buffer frame;
+        for (size_t x = 0; x < full_columns; x++)
+        {
+            frame.set_column(x, 0xff);
+        }
+        if (full_columns < frame_buffer::width)
+        {
+            frame.set_column(full_columns, partial_columns[position % steps_per_column]);
+        }
+        return frame;
+    }
+
+  private:
+    // rows lit from the bottom, bit 7 is the bottom row
+    constexpr static std::array<uint8_t, steps_per_column> partial_columns = {0x00, 0x80, 0xc0, 0xe0, 0xf0, 0xf8, 0xfc, 0xfe};
+
+    std::array<uint16_t, UINT8_MAX + 1> positions_{};
+};
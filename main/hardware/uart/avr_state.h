@@ -0,0 +1,125 @@
+#pragma once
+
+#include "util/fixed_string.h"
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <stdint.h>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+/**
+ * Last known state of the AVR, built from its feedback.
+ */
+struct avr_state
+{
+    enum class power_t : uint8_t
+    {
+        on,
+        standby,
+    };
+
+    enum class dynamic_volume_t : uint8_t
+    {
+        off,
+        light,
+        medium,
+        heavy,
+    };
+
+    /// Volume in half dB steps of the Denon scale, e.g. "MV455" is 91.
+    typedef struct volume_t
+    {
+        uint8_t half_db;
+        bool operator==(const volume_t &) const = default;
+    } volume_t;
+
+    typedef struct max_volume_t
+    {
+        uint8_t half_db;
+        bool operator==(const max_volume_t &) const = default;
+    } max_volume_t;
+
+    typedef struct mute_t
+    {
+        bool on;
+        bool operator==(const mute_t &) const = default;
+    } mute_t;
+
+    typedef struct input_source_t
+    {
+        fixed_string<16> name;
+        bool operator==(const input_source_t &) const = default;
+    } input_source_t;
+
+    typedef struct surround_mode_t
+    {
+        fixed_string<24> name;
+        bool operator==(const surround_mode_t &) const = default;
+    } surround_mode_t;
+
+    /**
+     * A single field update, the alternative identifies the field.
+     */
+    using delta = std::variant<power_t, volume_t, max_volume_t, mute_t, dynamic_volume_t, input_source_t, surround_mode_t>;
+
+    std::optional<power_t> power;
+    std::optional<volume_t> master_volume;
+    std::optional<max_volume_t> max_volume;
+    std::optional<mute_t> mute;
+    std::optional<dynamic_volume_t> dynamic_volume;
+    std::optional<input_source_t> input_source;
+    std::optional<surround_mode_t> surround_mode;
+
+    /**
+     * Applies the update, returns false if the field already had that value.
+     */
+    bool apply(const delta &value);
+};
+
+using avr_state_delta = avr_state::delta;
+
+static_assert(std::is_trivially_copyable_v<avr_state_delta>);
+
+/**
+ * Payload of AVR_STATE_CHANGED. Times are from esp32::timer::get_time and only used to track latency.
+ */
+typedef struct avr_state_update
+{
+    avr_state_delta delta;
+    // uart event that delivered the frame's CR
+    int64_t received_at_us;
+    int64_t framed_at_us;
+} avr_state_update;
+
+static_assert(std::is_trivially_copyable_v<avr_state_update>);
+
+inline bool avr_state::apply(const delta &delta_value)
+{
+    return std::visit(
+        [this](auto &&value) {
+            using T = std::decay_t<decltype(value)>;
+            auto update = [&value](auto &field) {
+                const bool changed = !field.has_value() || !(*field == value);
+                field = value;
+                return changed;
+            };
+
+            if constexpr (std::is_same_v<T, power_t>)
+                return update(power);
+            else if constexpr (std::is_same_v<T, volume_t>)
+                return update(master_volume);
+            else if constexpr (std::is_same_v<T, max_volume_t>)
+                return update(max_volume);
+            else if constexpr (std::is_same_v<T, mute_t>)
+                return update(mute);
+            else if constexpr (std::is_same_v<T, dynamic_volume_t>)
+                return update(dynamic_volume);
+            else if constexpr (std::is_same_v<T, input_source_t>)
+                return update(input_source);
+            else
+                return update(surround_mode);
+        },
+        delta_value);
+}
@@ -0,0 +1,146 @@
+#include "avr_state_parser.h"
+#include "util/prefix_dispatch.h"
+#include <algorithm>
+
+namespace
+{
+using parse_result = std::optional<avr_state_delta>;
+using handler_t = parse_result (*)(std::string_view arguments);
+
+// Denon volume: two digits, optionally followed by '5' for the half step
+std::optional<uint8_t> parse_half_db(std::string_view value)
+{
+    const auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+    if ((value.size() != 2 && value.size() != 3) || !std::all_of(value.begin(), value.end(), is_digit))
+    {
+        return std::nullopt;
+    }
+
+    const auto whole = (value[0] - '0') * 10 + (value[1] - '0');
+    const auto half = (value.size() == 3 && value[2] == '5') ? 1 : 0;
+    return static_cast<uint8_t>(whole * 2 + half);
+}
+
+parse_result parse_mute(std::string_view arguments)
+{
+    constexpr static std::string_view on_command("ON");
+    constexpr static std::string_view off_command("OFF");
+    if (arguments == on_command)
+    {
+        return avr_state::mute_t{true};
+    }
+    else if (arguments == off_command)
+    {
+        return avr_state::mute_t{false};
+    }
+    return std::nullopt;
+}
+
+parse_result parse_power(std::string_view arguments)
+{
+    constexpr static std::string_view standby_command("STANDBY");
+    constexpr static std::string_view on_command("ON");
+    if (arguments == standby_command)
+    {
+        return avr_state::power_t::standby;
+    }
+    else if (arguments == on_command)
+    {
+        return avr_state::power_t::on;
+    }
+    return std::nullopt;
+}
+
+parse_result parse_volume_max(std::string_view arguments)
+{
+    if (arguments.empty())
+    {
+        return std::nullopt;
+    }
+    const auto value = parse_half_db(arguments.substr(1));
+    if (!value.has_value())
+    {
+        return std::nullopt;
+    }
+    return avr_state::max_volume_t{*value};
+}
+
+parse_result parse_volume(std::string_view arguments)
+{
+    const auto value = parse_half_db(arguments);
+    if (!value.has_value())
+    {
+        return std::nullopt;
+    }
+    return avr_state::volume_t{*value};
+}
+
+parse_result parse_dynamic_volume(std::string_view arguments)
+{
+    if (arguments.empty())
+    {
+        return std::nullopt;
+    }
+    const auto dynvol_string = arguments.substr(1);
+
+    constexpr static std::string_view off_command("OFF");
+    constexpr static std::string_view light_command("LIT");
+    constexpr static std::string_view med_command("MED");
+    constexpr static std::string_view hev_command("HEV");
+    if (off_command == dynvol_string)
+    {
+        return avr_state::dynamic_volume_t::off;
+    }
+    else if (light_command == dynvol_string)
+    {
+        return avr_state::dynamic_volume_t::light;
+    }
+    else if (med_command == dynvol_string)
+    {
+        return avr_state::dynamic_volume_t::medium;
+    }
+    else if (hev_command == dynvol_string)
+    {
+        return avr_state::dynamic_volume_t::heavy;
+    }
+    return std::nullopt;
+}
+
+parse_result parse_input_source(std::string_view arguments)
+{
+    if (arguments.empty())
+    {
+        return std::nullopt;
+    }
+    return avr_state::input_source_t{fixed_string<16>::from(arguments)};
+}
+
+parse_result parse_surround_mode(std::string_view arguments)
+{
+    if (arguments.empty())
+    {
+        return std::nullopt;
+    }
+    return avr_state::surround_mode_t{fixed_string<24>::from(arguments)};
+}
+
+constexpr esp32::prefix_dispatch<handler_t, 7> feedback_handlers{{{
+    {"MU", parse_mute},
+    {"PW", parse_power},
+    {"MVMAX", parse_volume_max},
+    {"MV", parse_volume},
+    {"PSDYNVOL", parse_dynamic_volume},
+    {"SI", parse_input_source},
+    {"MS", parse_surround_mode},
+}}};
+} // namespace
+
+std::optional<avr_state_delta> avr_state_parser::parse(std::string_view feedback)
+{
+    const auto entry = feedback_handlers.find(feedback);
+    if (entry == nullptr)
+    {
+        return std::nullopt;
+    }
+    return entry->handler(feedback.substr(entry->prefix.size()));
+}
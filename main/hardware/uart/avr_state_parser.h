@@ -0,0 +1,18 @@
+#pragma once
+
+#include "avr_state.h"
+#include <optional>
+#include <string_view>
+
+/**
+ * Parses feedback frames from the AVR into state updates.
+ * Has no dependency on the hardware or FreeRTOS so it can be compiled for the host.
+ */
+class avr_state_parser
+{
+  public:
+    /**
+     * Returns the update carried by the frame, or nothing if the frame is not recognised.
+     */
+    static std::optional<avr_state_delta> parse(std::string_view feedback);
+};
@@ -1,44 +1,169 @@
 #pragma once
 
-#include "util/semaphore_lockable.h"
+#include "util/spsc_circular_buffer.h"
 #include <algorithm>
-#include <mutex>
-#include <string>
+#include <array>
+#include <atomic>
+#include <stdint.h>
 #include <string_view>
 
+constexpr static size_t MAX_COMMAND_SIZE = 135;
+
+/**
+ * Splits the UART stream into CR terminated frames.
+ * add_data must only be called by a single producer and pop_command by a
+ * single consumer. In denon_avr both run on the uart task; the frame ring is
+ * still safe if the consumer is moved to another task, which the host stress
+ * test covers.
+ */
 class command_processor
 {
   public:
-    bool add_data(std::string_view data)
+    /**
+     * A single CR terminated command. Storage is inline so that queuing a
+     * frame never allocates.
+     */
+    struct frame
     {
-        std::lock_guard<esp32::semaphore> lock(mutex);
-        constexpr char separator = 0x0D;
-        auto iter = std::find(data.begin(), data.end(), separator);
+        std::array<char, MAX_COMMAND_SIZE> data;
+        uint8_t length;
 
-        // no separator found
-        if (iter == data.end())
+        std::string_view view() const
         {
-            buffer.append(data);
-            return false;
+            return std::string_view(data.data(), length);
         }
-        else
+    };
+
+    constexpr static size_t max_pending_frames = 16;
+
+    typedef struct loss_stats
+    {
+        // bytes thrown away by the framer, not counting bytes the uart lost itself
+        uint32_t bytes_dropped;
+        uint32_t frames_dropped;
+        uint32_t overflow_events;
+    } loss_stats;
+
+    /**
+     * Splits the data on CR and queues every complete frame found in it.
+     * Returns the number of frames queued. Producer only.
+     */
+    size_t add_data(std::string_view data)
+    {
+        size_t frames_added = 0;
+        while (true)
         {
-            const auto pos = std::distance(data.begin(), iter);
-            buffer.append(data.substr(0, pos));
-            last_command = std::move(buffer);
-            buffer = data.substr(pos + 1);
-            return true;
+            const auto pos = data.find(separator);
+            append_partial(data.substr(0, pos));
+
+            // no separator found
+            if (pos == std::string_view::npos)
+            {
+                break;
+            }
+
+            // frame is dropped if the consumer has fallen behind by a full ring
+            if (!discarding)
+            {
+                if (frames.push(partial))
+                {
+                    frames_added++;
+                }
+                else
+                {
+                    drop_frame(partial.length);
+                }
+            }
+
+            partial.length = 0;
+            discarding = false;
+            data.remove_prefix(pos + 1);
         }
+        return frames_added;
     }
 
-    const auto &get_last_command() const
+    /**
+     * Called after the uart lost data at the current end of the stream. The
+     * frame in progress is torn, so it is dropped and everything up to the
+     * next CR is discarded, frames after that are received as usual. Producer only.
+     */
+    void resync()
     {
-        std::lock_guard<esp32::semaphore> lock(mutex);
-        return last_command;
+        overflow_events++;
+        if (!discarding)
+        {
+            drop_frame(partial.length);
+            partial.length = 0;
+            discarding = true;
+        }
+    }
+
+    /**
+     * Records an overflow which lost no data. Producer only.
+     */
+    void record_overflow()
+    {
+        overflow_events++;
+    }
+
+    loss_stats get_loss_stats() const
+    {
+        return loss_stats{
+            .bytes_dropped = bytes_dropped.load(),
+            .frames_dropped = frames_dropped.load(),
+            .overflow_events = overflow_events.load(),
+        };
+    }
+
+    /**
+     * Removes the oldest complete frame. Returns false if there is none. Consumer only.
+     */
+    bool pop_command(frame &command)
+    {
+        return frames.pop(command);
     }
 
   private:
-    mutable esp32::semaphore mutex;
-    std::string buffer;
-    std::string last_command;
+    constexpr static char separator = 0x0D;
+
+    spsc_circular_buffer<frame, max_pending_frames> frames;
+    frame partial{};
+    bool discarding{false};
+
+    // written by the producer only, read from anywhere
+    std::atomic<uint32_t> bytes_dropped{0};
+    std::atomic<uint32_t> frames_dropped{0};
+    std::atomic<uint32_t> overflow_events{0};
+
+    void drop_frame(size_t length)
+    {
+        frames_dropped++;
+        bytes_dropped += length;
+    }
+
+    void append_partial(std::string_view data)
+    {
+        if (data.empty())
+        {
+            return;
+        }
+
+        if (discarding)
+        {
+            bytes_dropped += data.size();
+            return;
+        }
+
+        // frame longer than any valid command, drop it up to the next CR
+        if (partial.length + data.size() > partial.data.size())
+        {
+            drop_frame(partial.length + data.size());
+            partial.length = 0;
+            discarding = true;
+            return;
+        }
+
+        std::copy(data.begin(), data.end(), partial.data.begin() + partial.length);
+        partial.length += data.size();
+    }
 };
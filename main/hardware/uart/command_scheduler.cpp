@@ -0,0 +1,116 @@
+#include "command_scheduler.h"
+#include <algorithm>
+
+void command_scheduler::request_all()
+{
+    for (auto &status : status_)
+    {
+        status = query_status{query_state::queued, 0, {}, 0};
+    }
+}
+
+std::optional<std::string_view> command_scheduler::next_command(time_point now)
+{
+    if (!connected_ && next_probe_at_.has_value() && now >= *next_probe_at_)
+    {
+        // power query only, the full state is requested once it answers
+        next_probe_at_ = now + probe_interval;
+        status_[0] = query_status{query_state::queued, 0, {}, 0};
+    }
+
+    if (last_sent_at_.has_value() && now < *last_sent_at_ + command_spacing)
+    {
+        return std::nullopt;
+    }
+
+    for (size_t i = 0; i < status_.size(); i++)
+    {
+        auto &status = status_[i];
+        if (status.state == query_state::sent && now >= status.sent_at + response_timeout)
+        {
+            if (status.attempts >= max_attempts)
+            {
+                // an AVR which talks but does not answer just does not support the query
+                status.state = query_state::idle;
+                if (status.frames_at_first_send == frames_received_)
+                {
+                    disconnected(now);
+                }
+                continue;
+            }
+            status.state = query_state::queued;
+        }
+
+        if (status.state == query_state::queued)
+        {
+            if (status.attempts == 0)
+            {
+                status.frames_at_first_send = frames_received_;
+            }
+            status.state = query_state::sent;
+            status.attempts++;
+            status.sent_at = now;
+            last_sent_at_ = now;
+            return status_queries[i].command;
+        }
+    }
+    return std::nullopt;
+}
+
+void command_scheduler::on_frame(std::string_view frame)
+{
+    frames_received_++;
+    if (!connected_)
+    {
+        connected_ = true;
+        next_probe_at_.reset();
+        request_all();
+    }
+
+    for (size_t i = 0; i < status_.size(); i++)
+    {
+        if (status_[i].state != query_state::idle && frame.starts_with(status_queries[i].response_prefix))
+        {
+            status_[i].state = query_state::idle;
+        }
+    }
+}
+
+std::optional<command_scheduler::time_point> command_scheduler::next_deadline() const
+{
+    std::optional<time_point> deadline;
+    auto earliest = [&deadline](time_point value) { deadline = deadline.has_value() ? std::min(*deadline, value) : value; };
+
+    const auto spacing_end = last_sent_at_.value_or(time_point{}) + command_spacing;
+    for (auto &&status : status_)
+    {
+        if (status.state == query_state::queued)
+        {
+            earliest(spacing_end);
+        }
+        else if (status.state == query_state::sent)
+        {
+            earliest(std::max(status.sent_at + response_timeout, spacing_end));
+        }
+    }
+
+    if (next_probe_at_.has_value())
+    {
+        earliest(*next_probe_at_);
+    }
+    return deadline;
+}
+
+void command_scheduler::disconnected(time_point now)
+{
+    if (connected_)
+    {
+        connected_ = false;
+        next_probe_at_ = now + probe_interval;
+        // the rest would only time out as well
+        for (auto &status : status_)
+        {
+            status.state = query_state::idle;
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <optional>
+#include <stdint.h>
+#include <string_view>
+
+/**
+ * Decides when status queries are sent to the AVR and matches the feedback to them.
+ *
+ * Queries are pipelined: the next one goes out as soon as the minimum spacing
+ * between commands has passed, without waiting for the previous response. A
+ * query is answered by any frame starting with its response prefix and is
+ * sent again if no answer arrives in time. When a query stays unanswered
+ * and nothing at all was received meanwhile, the AVR is considered
+ * disconnected and is probed periodically, the first frame received
+ * afterwards queries the full state again.
+ *
+ * Has no dependency on the hardware or FreeRTOS, the caller passes in the time.
+ */
+class command_scheduler
+{
+  public:
+    using time_point = std::chrono::microseconds;
+
+    typedef struct query
+    {
+        std::string_view command;
+        std::string_view response_prefix;
+    } query;
+
+    static constexpr std::array<query, 6> status_queries{{
+        {"PW?", "PW"},
+        {"MV?", "MV"},
+        {"MU?", "MU"},
+        {"PSDYNVOL ?", "PSDYNVOL"},
+        {"SI?", "SI"},
+        {"MS?", "MS"},
+    }};
+
+    // Denon protocol: at least 50 ms between commands, the response follows within 200 ms
+    static constexpr std::chrono::milliseconds command_spacing{50};
+    static constexpr std::chrono::milliseconds response_timeout{200};
+    static constexpr uint8_t max_attempts = 3;
+    static constexpr std::chrono::seconds probe_interval{5};
+
+    /**
+     * Queues every status query.
+     */
+    void request_all();
+
+    /**
+     * Returns the command to send now, if any, and records it as sent.
+     */
+    std::optional<std::string_view> next_command(time_point now);
+
+    /**
+     * Matches a received frame against the queries waiting for a response.
+     */
+    void on_frame(std::string_view frame);
+
+    /**
+     * Time at which next_command should be called again, nothing if it is idle.
+     */
+    std::optional<time_point> next_deadline() const;
+
+    bool is_connected() const
+    {
+        return connected_;
+    }
+
+  private:
+    enum class query_state : uint8_t
+    {
+        idle,
+        queued,
+        sent,
+    };
+
+    struct query_status
+    {
+        query_state state;
+        uint8_t attempts;
+        time_point sent_at;
+        // frames_received_ when the query was first sent
+        uint32_t frames_at_first_send;
+    };
+
+    std::array<query_status, status_queries.size()> status_{};
+    std::optional<time_point> last_sent_at_;
+    std::optional<time_point> next_probe_at_;
+    uint32_t frames_received_{0};
+    bool connected_{true};
+
+    void disconnected(time_point now);
+};
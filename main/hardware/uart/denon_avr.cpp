@@ -1,20 +1,30 @@
 #include "denon_avr.h"
+#include "avr_state_parser.h"
 #include "driver/gpio.h"
 #include "driver/uart.h"
 #include "logging/logging_tags.h"
 #include "util/cores.h"
-#include "util/default_event.h"
 #include "util/exceptions.h"
 #include "util/helper.h"
+#include "util/latency_stats.h"
+#include <algorithm>
+#include <cinttypes>
 #include <driver/spi_master.h>
 #include <esp_log.h>
 
 constexpr static int TX_PIN = 26;
 constexpr static int RX_PIN = 25;
-constexpr static size_t MAX_COMMAND_SIZE = 135;
 constexpr static char PATTERN_CHAR = 0x0D;
 constexpr static size_t PATTERN_SIZE = 1;
 constexpr static uart_port_t UART_SEL = UART_NUM_2;
+// must be larger than the hardware fifo, queries are written without waiting for the fifo
+constexpr static int TX_BUFFER_SIZE = 256;
+
+// wake the task once per CR from the driver's pattern detection, instead of for every chunk of received data
+constexpr static bool PATTERN_DETECT_RX = true;
+constexpr static int PATTERN_QUEUE_SIZE = 32;
+// with the rx timeout off, data without a CR is only moved out of the fifo at this fill level
+constexpr static uint8_t PATTERN_RX_FULL_THRESHOLD = 100;
 
 void denon_avr::begin()
 {
@@ -30,31 +40,43 @@ void denon_avr::begin()
         .source_clk = UART_SCLK_DEFAULT,
     };
 
-    // We won't use a buffer for sending data.
-    CHECK_THROW_ESP(uart_driver_install(UART_SEL, MAX_COMMAND_SIZE * 10, 0, 32, &uart_queue, ESP_INTR_FLAG_IRAM));
+    CHECK_THROW_ESP(uart_driver_install(UART_SEL, MAX_COMMAND_SIZE * 10, TX_BUFFER_SIZE, 32, &uart_queue, ESP_INTR_FLAG_IRAM));
     CHECK_THROW_ESP(uart_param_config(UART_SEL, &uart_config));
     CHECK_THROW_ESP(uart_set_pin(UART_SEL, TX_PIN, RX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE));
 
     uart_set_mode(UART_SEL, UART_MODE_UART);
+
+    if constexpr (PATTERN_DETECT_RX)
+    {
+        CHECK_THROW_ESP(uart_enable_pattern_det_baud_intr(UART_SEL, PATTERN_CHAR, PATTERN_SIZE, 1, 0, 0));
+        CHECK_THROW_ESP(uart_pattern_queue_reset(UART_SEL, PATTERN_QUEUE_SIZE));
+        CHECK_THROW_ESP(uart_set_rx_timeout(UART_SEL, 0));
+        CHECK_THROW_ESP(uart_set_rx_full_threshold(UART_SEL, PATTERN_RX_FULL_THRESHOLD));
+    }
     ESP_LOGI(DENON_AVR_TAG, "Setting up denon_avr");
 
+    // the display knows nothing until the AVR is asked for its state
+    scheduler_.request_all();
+
     CHECK_THROW_ESP(uart_task_.spawn_pinned("uart", 1024 * 8, esp32::task::default_priority, esp32::uart_core));
     ESP_LOGI(DENON_AVR_TAG, "denon_avr setup done");
 }
 
 void denon_avr::uart_task()
 {
-    std::vector<char> read_data(512);
-
     ESP_LOGI(DENON_AVR_TAG, "Start to run denon_avr Task on core:%d", xPortGetCoreID());
     try
     {
         while (true)
         {
-            // Waiting for UART event.
+            send_scheduled_commands();
+
+            // Waiting for UART event, or until the next query is due.
             uart_event_t event{};
-            if (xQueueReceive(uart_queue, &event, portMAX_DELAY))
+            if (xQueueReceive(uart_queue, &event, ticks_until_scheduler_deadline()))
             {
+                rx_event_at_ = esp32::timer::get_time();
+                rx_wakeups_++;
                 ESP_LOGD(DENON_AVR_TAG, "uart event:%d", event.type);
                 switch (event.type)
                 {
@@ -64,32 +86,31 @@ void denon_avr::uart_task()
                 be full.*/
                 case UART_DATA: {
                     ESP_LOGD(DENON_AVR_TAG, "UART DATA size: %d", event.size);
-                    const auto length = uart_read_bytes(UART_SEL, read_data.data(), event.size, 20 / portTICK_PERIOD_MS);
-                    ESP_LOGI(DENON_AVR_TAG, "Data:%.*s", length, reinterpret_cast<const char *>(read_data.data()));
-                    const bool command_changed = processor.add_data(std::string_view(read_data.data(), length));
-                    if (command_changed)
+                    if constexpr (!PATTERN_DETECT_RX)
                     {
-                        CHECK_THROW_ESP(esp32::event_post(APP_COMMON_EVENT, NEW_FEEDBACK_RECEIVED));
+                        process_feedback(read_into_processor(event.size));
                     }
+                    // otherwise the data stays buffered until its CR is detected
+                }
+                break;
+
+                case UART_PATTERN_DET: {
+                    read_pattern_frames();
                 }
                 break;
 
                 case UART_FIFO_OVF: { // Event of HW FIFO overflow detected
+                    // The ISR has already reset the rx FIFO, so bytes are missing after what is buffered.
+                    // Frames completed before the loss are kept, the torn one is dropped up to the next CR.
                     ESP_LOGW(DENON_AVR_TAG, "hw fifo overflow");
-                    // If fifo overflow happened, you should consider adding flow control for your application.
-                    // The ISR has already reset the rx FIFO,
-                    // As an example, we directly flush the rx buffer here in order to read more data.
-                    CHECK_THROW_ESP(uart_flush_input(UART_SEL));
-                    xQueueReset(uart_queue);
+                    drain_rx_buffer(true);
                 }
                 break;
 
                 case UART_BUFFER_FULL: { // Event of UART ring buffer full
+                    // The driver holds further data back until there is space again, nothing is lost yet.
                     ESP_LOGW(DENON_AVR_TAG, "ring buffer full");
-                    // If buffer full happened, you should consider increasing your buffer size
-                    // As an example, we directly flush the rx buffer here in order to read more data.
-                    CHECK_THROW_ESP(uart_flush_input(UART_SEL));
-                    xQueueReset(uart_queue);
+                    drain_rx_buffer(false);
                 }
                 break;
 
@@ -127,3 +148,184 @@ void denon_avr::uart_task()
 
     vTaskDelete(NULL);
 }
+
+size_t denon_avr::read_into_processor(size_t length)
+{
+    size_t frames_added = 0;
+    while (length)
+    {
+        const auto read = uart_read_bytes(UART_SEL, read_data_.data(), std::min(length, read_data_.size()), 20 / portTICK_PERIOD_MS);
+        if (read <= 0)
+        {
+            break;
+        }
+        ESP_LOGD(DENON_AVR_TAG, "Data:%.*s", read, read_data_.data());
+#if RECORD_UART_TRACE
+        record_trace(std::string_view(read_data_.data(), read));
+#endif
+        frames_added += processor.add_data(std::string_view(read_data_.data(), read));
+        length -= read;
+    }
+    return frames_added;
+}
+
+void denon_avr::read_pattern_frames()
+{
+    // one event can stand for several CRs, pop all of them
+    size_t frames_added = 0;
+    int position;
+    while ((position = uart_pattern_pop_pos(UART_SEL)) != -1)
+    {
+        // positions count from the current read position, so each pop is relative to what was read before
+        frames_added += read_into_processor(position + PATTERN_SIZE);
+    }
+
+    if (!frames_added)
+    {
+        // positions were lost when the pattern queue was full, the framer still splits whatever is buffered
+        size_t buffered = 0;
+        CHECK_THROW_ESP(uart_get_buffered_data_len(UART_SEL, &buffered));
+        frames_added = read_into_processor(buffered);
+    }
+
+    process_feedback(frames_added);
+}
+
+void denon_avr::drain_rx_buffer(bool data_lost)
+{
+    size_t buffered = 0;
+    CHECK_THROW_ESP(uart_get_buffered_data_len(UART_SEL, &buffered));
+    const auto frames_added = read_into_processor(buffered);
+    if constexpr (PATTERN_DETECT_RX)
+    {
+        // queued positions point into data just read, a CR arriving meanwhile is picked up by the fallback read
+        CHECK_THROW_ESP(uart_pattern_queue_reset(UART_SEL, PATTERN_QUEUE_SIZE));
+    }
+    process_feedback(frames_added);
+
+    if (data_lost)
+    {
+        processor.resync();
+    }
+    else
+    {
+        processor.record_overflow();
+    }
+
+    const auto stats = processor.get_loss_stats();
+    ESP_LOGW(DENON_AVR_TAG, "Overflows:%" PRIu32 " frames dropped:%" PRIu32 " bytes dropped:%" PRIu32, stats.overflow_events,
+             stats.frames_dropped, stats.bytes_dropped);
+}
+
+void denon_avr::process_feedback(size_t frames)
+{
+    if (!frames)
+    {
+        return;
+    }
+
+    rx_frames_ += frames;
+    ESP_LOGD(DENON_AVR_TAG, "%" PRIu32 " uart wakeups for %" PRIu32 " frames", rx_wakeups_.load(), rx_frames_.load());
+
+    const auto framed_at = esp32::timer::get_time();
+    command_processor::frame feedback;
+    while (processor.pop_command(feedback))
+    {
+        latency_stats::record(latency_stats::stage::uart_to_frame, framed_at - rx_event_at_);
+        scheduler_.on_frame(feedback.view());
+        const auto delta = avr_state_parser::parse(feedback.view());
+        if (!delta.has_value())
+        {
+            ESP_LOGD(DENON_AVR_TAG, "Ignored feedback:%.*s", feedback.length, feedback.data.data());
+            continue;
+        }
+
+        // the other values may have changed while it was in standby
+        const auto *power = std::get_if<avr_state::power_t>(&*delta);
+        if (power && *power == avr_state::power_t::on && state_.power == avr_state::power_t::standby)
+        {
+            scheduler_.request_all();
+        }
+
+        // posted even if the value did not change, the AVR only reports in response to user action
+        state_.apply(*delta);
+        const avr_state_update update{*delta, rx_event_at_.count(), framed_at.count()};
+        if (app_event_bus::instance().post(AVR_STATE_CHANGED, update, app_event_bus::lane::priority) != ESP_OK)
+        {
+            // never waits on the display, a newer state follows anyway
+            ESP_LOGW(DENON_AVR_TAG, "Dropped state update");
+        }
+    }
+}
+
+TickType_t denon_avr::ticks_until_scheduler_deadline() const
+{
+    const auto deadline = scheduler_.next_deadline();
+    if (!deadline.has_value())
+    {
+        return portMAX_DELAY;
+    }
+
+    const auto now = esp32::timer::get_time();
+    if (*deadline <= now)
+    {
+        return 0;
+    }
+    // rounded up, waking early would only wait again
+    return pdMS_TO_TICKS(std::chrono::ceil<std::chrono::milliseconds>(*deadline - now).count()) + 1;
+}
+
+void denon_avr::send_scheduled_commands()
+{
+    std::optional<std::string_view> command;
+    while ((command = scheduler_.next_command(esp32::timer::get_time())).has_value())
+    {
+        send_command(*command);
+    }
+}
+
+void denon_avr::send_command(std::string_view command)
+{
+    std::array<char, MAX_COMMAND_SIZE + 1> buffer;
+    const auto length = std::min(command.size(), MAX_COMMAND_SIZE);
+    std::copy_n(command.begin(), length, buffer.begin());
+    buffer[length] = PATTERN_CHAR;
+
+    ESP_LOGD(DENON_AVR_TAG, "Sending:%.*s", static_cast<int>(length), command.data());
+    if (uart_write_bytes(UART_SEL, buffer.data(), length + 1) < 0)
+    {
+        ESP_LOGW(DENON_AVR_TAG, "Failed to send:%.*s", static_cast<int>(length), command.data());
+    }
+}
+
+#if RECORD_UART_TRACE
+void denon_avr::record_trace(std::string_view chunk)
+{
+    const auto now = esp32::timer::get_time();
+    if (!trace_.append(now, chunk))
+    {
+        log_trace();
+        trace_.reset();
+        trace_.append(now, chunk);
+    }
+}
+
+void denon_avr::log_trace()
+{
+    // hex lines that host_test/replay_trace reads back from the log, see uart_trace.h for the format
+    constexpr size_t bytes_per_line = 32;
+    const auto trace = trace_.data();
+    ESP_LOGI(DENON_AVR_TAG, "UART trace begin, %u bytes", static_cast<unsigned>(trace.size()));
+    for (size_t offset = 0; offset < trace.size(); offset += bytes_per_line)
+    {
+        const auto line = trace.subspan(offset, std::min(bytes_per_line, trace.size() - offset));
+        std::array<char, bytes_per_line * 2 + 1> hex;
+        for (size_t i = 0; i < line.size(); i++)
+        {
+            snprintf(&hex[i * 2], 3, "%02x", line[i]);
+        }
+        ESP_LOGI(DENON_AVR_TAG, "%.*s", static_cast<int>(line.size() * 2), hex.data());
+    }
+    ESP_LOGI(DENON_AVR_TAG, "UART trace end");
+}
+#endif
@@ -1,21 +1,46 @@
 #pragma once
 
 #include "app_events.h"
+#include "avr_state.h"
 #include "command_processor.h"
-#include "util/default_event.h"
+#include "command_scheduler.h"
+#include "uart_trace.h"
 #include "util/semaphore_lockable.h"
 #include "util/singleton.h"
 #include "util/task_wrapper.h"
 #include "util/timer/timer.h"
+#include <array>
+#include <atomic>
 #include <variant>
 
+// records every received chunk with its time, the trace is logged as hex whenever the buffer is full
+#ifndef RECORD_UART_TRACE
+#define RECORD_UART_TRACE 0
+#endif
+
 class denon_avr final : public esp32::singleton<denon_avr>
 {
   public:
     void begin();
-    auto get_last_feedback() const
+
+    typedef struct rx_stats
     {
-        return processor.get_last_command();
+        // times the uart task was woken by the driver
+        uint32_t wakeups;
+        uint32_t frames;
+    } rx_stats;
+
+    rx_stats get_rx_stats() const
+    {
+        return rx_stats{.wakeups = rx_wakeups_.load(), .frames = rx_frames_.load()};
+    }
+
+    /**
+     * Data lost to uart overflows and framing, for sizing the receive buffers.
+     */
+    command_processor::loss_stats get_loss_stats() const
+    {
+        return processor.get_loss_stats();
     }
 
   private:
@@ -28,6 +53,29 @@ class denon_avr final : public esp32::singleton<denon_avr>
     esp32::task uart_task_;
     QueueHandle_t uart_queue;
     command_processor processor;
+    command_scheduler scheduler_;
+    avr_state state_;
+    std::array<char, 512> read_data_;
+
+#if RECORD_UART_TRACE
+    std::array<uint8_t, 4096> trace_buffer_;
+    uart_trace::writer trace_{trace_buffer_};
+#endif
+
+    std::chrono::microseconds rx_event_at_{0};
+    std::atomic<uint32_t> rx_wakeups_{0};
+    std::atomic<uint32_t> rx_frames_{0};
 
     void uart_task();
+    size_t read_into_processor(size_t length);
+#if RECORD_UART_TRACE
+    void record_trace(std::string_view chunk);
+    void log_trace();
+#endif
+    void read_pattern_frames();
+    void drain_rx_buffer(bool data_lost);
+    void process_feedback(size_t frames);
+    TickType_t ticks_until_scheduler_deadline() const;
+    void send_scheduled_commands();
+    void send_command(std::string_view command);
 };
\ No newline at end of file
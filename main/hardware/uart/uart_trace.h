@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <optional>
+#include <span>
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+
+/**
+ * Compact binary capture of the UART receive stream, for replaying field issues without hardware.
+ *
+ * A trace is the magic followed by one record per chunk, exactly as
+ * uart_read_bytes returned it:
+ *   varint  microseconds since the previous record (since 0 for the first)
+ *   varint  chunk length
+ *   bytes   chunk
+ * Varints are unsigned LEB128, so a typical record costs two bytes plus the data.
+ *
+ * Has no dependency on the hardware or FreeRTOS so it can be compiled for the host.
+ */
+namespace uart_trace
+{
+constexpr std::array<uint8_t, 4> magic{'D', 'T', 'R', '1'};
+
+typedef struct record
+{
+    std::chrono::microseconds time;
+    std::string_view data;
+} record;
+
+/**
+ * Appends records to a caller provided buffer.
+ */
+class writer
+{
+  public:
+    explicit writer(std::span<uint8_t> buffer) : buffer_(buffer)
+    {
+        reset();
+    }
+
+    /**
+     * Returns false, leaving the trace unchanged, if the record does not fit.
+     */
+    bool append(std::chrono::microseconds time, std::string_view chunk)
+    {
+        const auto start = size_;
+        const auto delta = static_cast<uint64_t>(std::max<int64_t>(time.count() - last_time_.count(), 0));
+        if (!put_varint(delta) || !put_varint(chunk.size()) || buffer_.size() - size_ < chunk.size())
+        {
+            size_ = start;
+            return false;
+        }
+
+        std::copy(chunk.begin(), chunk.end(), buffer_.begin() + size_);
+        size_ += chunk.size();
+        last_time_ = time;
+        return true;
+    }
+
+    void reset()
+    {
+        std::copy(magic.begin(), magic.end(), buffer_.begin());
+        size_ = magic.size();
+        last_time_ = {};
+    }
+
+    std::span<const uint8_t> data() const
+    {
+        return buffer_.first(size_);
+    }
+
+  private:
+    std::span<uint8_t> buffer_;
+    size_t size_{0};
+    std::chrono::microseconds last_time_{};
+
+    bool put_varint(uint64_t value)
+    {
+        do
+        {
+            if (size_ == buffer_.size())
+            {
+                return false;
+            }
+            const auto byte = static_cast<uint8_t>(value & 0x7f);
+            value >>= 7;
+            buffer_[size_++] = value ? (byte | 0x80) : byte;
+        } while (value);
+        return true;
+    }
+};
+
+/**
+ * Walks the records of a trace.
+ */
+class reader
+{
+  public:
+    explicit reader(std::span<const uint8_t> trace) : trace_(trace)
+    {
+        valid_ = trace_.size() >= magic.size() && std::equal(magic.begin(), magic.end(), trace_.begin());
+        position_ = magic.size();
+    }
+
+    bool is_valid() const
+    {
+        return valid_;
+    }
+
+    /**
+     * Whether all records have been read.
+     */
+    bool at_end() const
+    {
+        return position_ >= trace_.size();
+    }
+
+    /**
+     * Returns the next record, nothing at the end of the trace or if it is truncated.
+     * A truncated trace also stops being valid, the end of a complete one does not.
+     */
+    std::optional<record> next()
+    {
+        if (!valid_ || at_end())
+        {
+            return std::nullopt;
+        }
+
+        const auto delta = get_varint();
+        const auto length = get_varint();
+        if (!delta.has_value() || !length.has_value() || trace_.size() - position_ < *length)
+        {
+            valid_ = false;
+            return std::nullopt;
+        }
+
+        time_ += std::chrono::microseconds(*delta);
+        const auto data = std::string_view(reinterpret_cast<const char *>(trace_.data()) + position_, *length);
+        position_ += *length;
+        return record{time_, data};
+    }
+
+  private:
+    std::span<const uint8_t> trace_;
+    size_t position_;
+    std::chrono::microseconds time_{};
+    bool valid_;
+
+    std::optional<uint64_t> get_varint()
+    {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64 && position_ < trace_.size(); shift += 7)
+        {
+            const auto byte = trace_[position_++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+            {
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+};
+} // namespace uart_trace
@@ -3,4 +3,5 @@
 constexpr static char OPERATIONS_TAG[] = "operations";
 constexpr static char DISPLAY_TAG[] = "display";
 constexpr static char DENON_AVR_TAG[] = "denon";
-constexpr static char CONFIG_TAG[] = "config";
\ No newline at end of file
+constexpr static char CONFIG_TAG[] = "config";
+constexpr static char LATENCY_TAG[] = "latency";
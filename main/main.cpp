@@ -5,18 +5,20 @@
 #include "logging/logging_tags.h"
 #include "nvs.h"
 #include "sdkconfig.h"
-#include "util/default_event.h"
+#include "util/cores.h"
 #include "util/exceptions.h"
+#include "util/latency_stats.h"
+#include "util/ota_health_gate.h"
+#include "util/timer/timer.h"
 #include <esp_log.h>
 #include <nvs_flash.h>
 #include <stdio.h>
 
-ESP_EVENT_DEFINE_BASE(APP_COMMON_EVENT);
-
 extern "C" void app_main(void)
 {
     ESP_LOGI(OPERATIONS_TAG, "Starting ....");
     esp_log_level_set("*", ESP_LOG_WARN);
+    esp_log_level_set(LATENCY_TAG, ESP_LOG_INFO);
 
     try
     {
@@ -28,23 +30,42 @@ extern "C" void app_main(void)
             CHECK_THROW_ESP(nvs_flash_init());
         }
 
-        CHECK_THROW_ESP(esp_event_loop_create_default());
+        CHECK_THROW_ESP(app_event_bus::instance().begin(1024 * 4, esp32::task::default_priority + 1, esp32::display_core));
 
         auto &config = config::create_instance();
         auto &denon_avr = denon_avr::create_instance();
-        auto &display = display::create_instance(config, denon_avr);
+        auto &display = display::create_instance(config);
 
         config.begin();
         display.begin();
         denon_avr.begin();
 
-        CHECK_THROW_ESP(esp32::event_post(APP_COMMON_EVENT, APP_INIT_DONE));
+        CHECK_THROW_ESP(app_event_bus::instance().post(APP_INIT_DONE));
+
+        // an updated image is only kept once the display works and it has heard from the avr. Without any
+        // frame the avr may just be off or unplugged, so instead of rolling back at the deadline the image
+        // stays pending until the avr answers; a reset before that still rolls back.
+        using health = esp32::ota_health_gate::health;
+        static esp32::ota_health_gate health_gate(
+            [&avr = denon_avr, &display] {
+                if (!display.is_initialized() || display.get_render_stats().rendered_frames == 0)
+                {
+                    return health::failing;
+                }
+                return avr.get_rx_stats().frames > 0 ? health::healthy : health::unknown;
+            },
+            std::chrono::seconds(30), std::chrono::minutes(2));
+        health_gate.begin();
+
+        static esp32::timer::timer latency_log_timer([](void *) { latency_stats::log(); }, nullptr, "latency_log");
+        latency_log_timer.start_periodic(std::chrono::minutes(1));
 
         ESP_LOGI(OPERATIONS_TAG, "Main task is done");
     }
     catch (const std::exception &ex)
     {
         ESP_LOGI(OPERATIONS_TAG, "Init Failure:%s", ex.what());
+        esp32::ota_health_gate::fail("init failure");
         vTaskDelay(pdMS_TO_TICKS(3000));
         throw;
     }
@@ -0,0 +1,296 @@
+#pragma once
+
+#include "util/noncopyable.h"
+#include "util/static_queue.h"
+#include "util/task_wrapper.h"
+#include <array>
+#include <atomic>
+#include <esp_err.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+namespace esp32
+{
+/**
+ * Application event bus with everything in static storage.
+ *
+ * Payloads are copied into fixed size slots of two preallocated queues, a
+ * priority lane for events the user sees and a normal lane. Posting never
+ * blocks and never allocates: if the lane is full the event is dropped and
+ * counted. A single dispatch task calls the subscribers of each event from a
+ * fixed table, always emptying the priority lane before taking the next
+ * normal event.
+ */
+template <size_t EventCount, size_t MaxPayload, size_t MaxSubscribers = 4, size_t LaneSize = 16> class event_bus : noncopyable
+{
+  public:
+    using handler_t = void (*)(void *context, int32_t event_id, const void *payload);
+
+    // subscribes to every event
+    constexpr static int32_t any_event = -1;
+
+    enum class lane : uint8_t
+    {
+        priority,
+        normal,
+    };
+
+    static event_bus &instance()
+    {
+        static event_bus bus;
+        return bus;
+    }
+
+    /**
+     * Starts dispatching, events posted before are refused.
+     */
+    esp_err_t begin(uint32_t stack_depth, uint32_t priority, BaseType_t cpu)
+    {
+        return dispatch_task_.spawn_pinned("event_bus", stack_depth, priority, cpu);
+    }
+
+    template <class T>
+        requires(std::is_trivially_copyable_v<T> && !std::is_pointer_v<T> && !std::is_reference_v<T>)
+    esp_err_t post(int32_t event_id, const T &payload, lane target_lane = lane::normal)
+    {
+        static_assert(sizeof(T) <= MaxPayload, "payload larger than the event slots");
+        return post(event_id, &payload, sizeof(T), target_lane);
+    }
+
+    esp_err_t post(int32_t event_id, lane target_lane = lane::normal)
+    {
+        return post(event_id, nullptr, 0, target_lane);
+    }
+
+    /**
+     * Adds a handler, returns false if the event already has the maximum number of subscribers.
+     */
+    bool subscribe(int32_t event_id, handler_t handler, void *context)
+    {
+        auto &table = subscribers_for(event_id);
+        bool added = false;
+        taskENTER_CRITICAL(&table_lock_);
+        for (auto &subscriber : table)
+        {
+            if (!subscriber.handler)
+            {
+                subscriber = {handler, context};
+                added = true;
+                break;
+            }
+        }
+        taskEXIT_CRITICAL(&table_lock_);
+        return added;
+    }
+
+    void unsubscribe(int32_t event_id, handler_t handler, void *context)
+    {
+        auto &table = subscribers_for(event_id);
+        taskENTER_CRITICAL(&table_lock_);
+        for (auto &subscriber : table)
+        {
+            if (subscriber.handler == handler && subscriber.context == context)
+            {
+                subscriber = {};
+            }
+        }
+        taskEXIT_CRITICAL(&table_lock_);
+    }
+
+    /**
+     * Events refused because their lane was full.
+     */
+    uint32_t get_dropped_events() const
+    {
+        return dropped_events_.load();
+    }
+
+  private:
+    event_bus() : dispatch_task_([this] { dispatch_task(); })
+    {
+    }
+
+    struct subscriber
+    {
+        handler_t handler;
+        void *context;
+    };
+    using subscriber_table = std::array<subscriber, MaxSubscribers>;
+
+    struct item
+    {
+        int32_t event_id;
+        uint8_t size;
+        alignas(8) std::array<uint8_t, MaxPayload> payload;
+    };
+
+    static_assert(MaxPayload <= UINT8_MAX, "payload size does not fit the slot header");
+
+    std::array<subscriber_table, EventCount> subscribers_{};
+    subscriber_table any_event_subscribers_{};
+    portMUX_TYPE table_lock_ = portMUX_INITIALIZER_UNLOCKED;
+
+    static_queue<item, LaneSize> priority_lane_;
+    static_queue<item, LaneSize> normal_lane_;
+    std::atomic<uint32_t> dropped_events_{0};
+    esp32::task dispatch_task_;
+
+    subscriber_table &subscribers_for(int32_t event_id)
+    {
+        if (event_id == any_event)
+        {
+            return any_event_subscribers_;
+        }
+        configASSERT(event_id >= 0 && static_cast<size_t>(event_id) < EventCount);
+        return subscribers_[event_id];
+    }
+
+    esp_err_t post(int32_t event_id, const void *payload, size_t size, lane target_lane)
+    {
+        configASSERT(event_id >= 0 && static_cast<size_t>(event_id) < EventCount);
+        const auto task = dispatch_task_.handle();
+        if (!task)
+        {
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        item event;
+        event.event_id = event_id;
+        event.size = static_cast<uint8_t>(size);
+        if (size)
+        {
+            memcpy(event.payload.data(), payload, size);
+        }
+
+        auto &queue = target_lane == lane::priority ? priority_lane_ : normal_lane_;
+        if (!queue.enqueue(event, 0))
+        {
+            dropped_events_++;
+            return ESP_ERR_TIMEOUT;
+        }
+        xTaskNotifyGive(task);
+        return ESP_OK;
+    }
+
+    void dispatch(const item &event)
+    {
+        subscriber_table table;
+        subscriber_table any_table;
+        taskENTER_CRITICAL(&table_lock_);
+        table = subscribers_[event.event_id];
+        any_table = any_event_subscribers_;
+        taskEXIT_CRITICAL(&table_lock_);
+
+        const void *payload = event.size ? event.payload.data() : nullptr;
+        for (auto &&subscriber : table)
+        {
+            if (subscriber.handler)
+            {
+                subscriber.handler(subscriber.context, event.event_id, payload);
+            }
+        }
+        for (auto &&subscriber : any_table)
+        {
+            if (subscriber.handler)
+            {
+                subscriber.handler(subscriber.context, event.event_id, payload);
+            }
+        }
+    }
+
+    void dispatch_task()
+    {
+        item event;
+        while (true)
+        {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            while (true)
+            {
+                if (priority_lane_.dequeue(event, 0) || normal_lane_.dequeue(event, 0))
+                {
+                    dispatch(event);
+                }
+                else
+                {
+                    break;
+                }
+            }
+        }
+    }
+};
+
+template <typename T> struct event_callback
+{
+    using type = void (*)(void *context, int32_t event_id, const T &payload);
+};
+
+template <> struct event_callback<void>
+{
+    using type = void (*)(void *context, int32_t event_id);
+};
+
+/**
+ * Typed subscription to one event, or to every event, of an event_bus. Same
+ * shape as default_event_subscriber_typed: create it as a member, subscribe
+ * once the owner is ready, it unsubscribes when destroyed.
+ *
+ * Like esp32::timer::timer the callback is a function pointer with a context,
+ * so a subscription needs no heap and dispatching calls it directly.
+ */
+template <class Bus, typename T> class event_subscriber_typed : noncopyable
+{
+  public:
+    using callback_t = typename event_callback<T>::type;
+
+    event_subscriber_typed(int32_t event_id, callback_t callback, void *context)
+        : event_id_(event_id), callback_(callback), context_(context)
+    {
+        configASSERT(callback_);
+    }
+
+    ~event_subscriber_typed()
+    {
+        unsubscribe();
+    }
+
+    void subscribe()
+    {
+        configASSERT(!subscribed_);
+        subscribed_ = Bus::instance().subscribe(event_id_, event_handler, this);
+        configASSERT(subscribed_);
+    }
+
+    void unsubscribe()
+    {
+        if (subscribed_)
+        {
+            Bus::instance().unsubscribe(event_id_, event_handler, this);
+            subscribed_ = false;
+        }
+    }
+
+  private:
+    const int32_t event_id_;
+    const callback_t callback_;
+    void *const context_;
+    bool subscribed_{false};
+
+    static void event_handler(void *context, int32_t event_id, const void *payload)
+    {
+        auto p_this = reinterpret_cast<event_subscriber_typed *>(context);
+        if constexpr (std::is_void_v<T>)
+        {
+            p_this->callback_(p_this->context_, event_id);
+        }
+        else
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            configASSERT(payload);
+            T value;
+            memcpy(&value, payload, sizeof(T));
+            p_this->callback_(p_this->context_, event_id, value);
+        }
+    }
+};
+} // namespace esp32
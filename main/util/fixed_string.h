@@ -0,0 +1,35 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+
+/**
+ * Fixed capacity string which stays trivially copyable so it can travel in event payloads.
+ * Longer values are truncated.
+ */
+template <size_t N> struct fixed_string
+{
+    std::array<char, N> data;
+    uint8_t length;
+
+    static fixed_string from(std::string_view value)
+    {
+        fixed_string result{};
+        result.length = static_cast<uint8_t>(std::min(value.size(), N));
+        std::copy_n(value.begin(), result.length, result.data.begin());
+        return result;
+    }
+
+    std::string_view view() const
+    {
+        return std::string_view(data.data(), length);
+    }
+
+    bool operator==(const fixed_string &other) const
+    {
+        return view() == other.view();
+    }
+};
@@ -1,58 +1,106 @@
+#pragma once
+
 #include <mbedtls/md.h>
+#include <mbedtls/sha256.h>
 
 #include "util/noncopyable.h"
 
-#include <cstring>
+#include <array>
+#include <cstddef>
+#include <span>
 #include <stdexcept>
-#include <vector>
+#include <string_view>
+#include <type_traits>
 
 namespace esp32::hash
 {
+/**
+ * Digest length in bytes, mbedtls only has this at runtime.
+ */
+template <mbedtls_md_type_t hashType> constexpr size_t digest_size()
+{
+    if constexpr (hashType == MBEDTLS_MD_MD5)
+        return 16;
+    else if constexpr (hashType == MBEDTLS_MD_SHA1 || hashType == MBEDTLS_MD_RIPEMD160)
+        return 20;
+    else if constexpr (hashType == MBEDTLS_MD_SHA224)
+        return 28;
+    else if constexpr (hashType == MBEDTLS_MD_SHA256)
+        return 32;
+    else if constexpr (hashType == MBEDTLS_MD_SHA384)
+        return 48;
+    else
+    {
+        static_assert(hashType == MBEDTLS_MD_SHA512, "unsupported hash type");
+        return 64;
+    }
+}
+
+/**
+ * Incremental hash over read-only input.
+ *
+ * SHA-256 calls the sha256 module directly, which uses the SHA accelerator
+ * when CONFIG_MBEDTLS_HARDWARE_SHA is set and does not allocate. Other types
+ * go through the generic md layer.
+ */
 template <mbedtls_md_type_t hashType> class hash : esp32::noncopyable
 {
   public:
+    using digest = std::array<uint8_t, digest_size<hashType>()>;
+
     hash()
     {
-        mbedtls_md_init(&ctx_);
-        auto ret = mbedtls_md_setup(&ctx_, mbedtls_md_info_from_type(hashType), 0);
-        if (ret != 0)
+        if constexpr (direct_sha256)
         {
-            throw std::runtime_error("Failed to set up hash algorithm");
+            mbedtls_sha256_init(&ctx_);
+            check(mbedtls_sha256_starts(&ctx_, 0), "Failed to start hash calculation");
         }
-        ret = mbedtls_md_starts(&ctx_);
-        if (ret != 0)
+        else
         {
-            throw std::runtime_error("Failed to start hash calculation");
+            mbedtls_md_init(&ctx_);
+            check(mbedtls_md_setup(&ctx_, mbedtls_md_info_from_type(hashType), 0), "Failed to set up hash algorithm");
+            check(mbedtls_md_starts(&ctx_), "Failed to start hash calculation");
         }
     }
 
     ~hash()
     {
-        mbedtls_md_free(&ctx_);
+        if constexpr (direct_sha256)
+        {
+            mbedtls_sha256_free(&ctx_);
+        }
+        else
+        {
+            mbedtls_md_free(&ctx_);
+        }
     }
 
-    void update(const std::string &input_string)
+    void update(std::span<const std::byte> input_data)
     {
-        update(reinterpret_cast<const uint8_t *>(input_string.c_str()), input_string.length());
+        const auto data = reinterpret_cast<const unsigned char *>(input_data.data());
+        if constexpr (direct_sha256)
+        {
+            check(mbedtls_sha256_update(&ctx_, data, input_data.size()), "Failed to update hash calculation");
+        }
+        else
+        {
+            check(mbedtls_md_update(&ctx_, data, input_data.size()), "Failed to update hash calculation");
+        }
     }
 
-    void update(const std::vector<uint8_t> &input_data)
+    void update(std::span<const uint8_t> input_data)
     {
-        update(input_data.data(), input_data.size());
+        update(std::as_bytes(input_data));
     }
 
-    void update(const std::span<uint8_t> &input_data)
+    void update(std::string_view input_string)
     {
-        update(input_data.data(), input_data.size());
+        update(std::as_bytes(std::span(input_string)));
     }
 
     void update(const uint8_t *input_data, size_t input_size)
     {
-        int ret = mbedtls_md_update(&ctx_, input_data, input_size);
-        if (ret != 0)
-        {
-            throw std::runtime_error("Failed to update hash calculation");
-        }
+        update(std::span(input_data, input_size));
     }
 
     void update(const void *input_data, size_t input_size)
@@ -60,22 +108,56 @@ template <mbedtls_md_type_t hashType> class hash : esp32::noncopyable
         update(static_cast<const uint8_t *>(input_data), input_size);
     }
 
-    std::vector<uint8_t> finish()
+    digest finish()
     {
-        std::vector<uint8_t> hash_result(mbedtls_md_get_size(mbedtls_md_info_from_type(hashType)));
-        int ret = mbedtls_md_finish(&ctx_, hash_result.data());
-        if (ret != 0)
+        digest hash_result;
+        if constexpr (direct_sha256)
+        {
+            check(mbedtls_sha256_finish(&ctx_, hash_result.data()), "Failed to finalize hash calculation");
+        }
+        else
         {
-            throw std::runtime_error("Failed to finalize hash calculation");
+            check(mbedtls_md_finish(&ctx_, hash_result.data()), "Failed to finalize hash calculation");
+        }
+        return hash_result;
+    }
+
+    /**
+     * Hashes a single buffer without keeping a context around.
+     */
+    static digest compute(std::span<const std::byte> input_data)
+    {
+        digest hash_result;
+        const auto data = reinterpret_cast<const unsigned char *>(input_data.data());
+        if constexpr (direct_sha256)
+        {
+            check(mbedtls_sha256(data, input_data.size(), hash_result.data(), 0), "Failed to calculate hash");
+        }
+        else
+        {
+            check(mbedtls_md(mbedtls_md_info_from_type(hashType), data, input_data.size(), hash_result.data()),
+                  "Failed to calculate hash");
         }
         return hash_result;
     }
 
   private:
-    mbedtls_md_context_t ctx_;
+    constexpr static bool direct_sha256 = hashType == MBEDTLS_MD_SHA256;
+
+    std::conditional_t<direct_sha256, mbedtls_sha256_context, mbedtls_md_context_t> ctx_;
+
+    static void check(int ret, const char *message)
+    {
+        if (ret != 0)
+        {
+            throw std::runtime_error(message);
+        }
+    }
 };
 
-template <class... Args> auto sha256(Args... data)
+using sha256_digest = hash<MBEDTLS_MD_SHA256>::digest;
+
+template <class... Args> sha256_digest sha256(Args &&...data)
 {
     esp32::hash::hash<MBEDTLS_MD_SHA256> hasher;
     hasher.update(std::forward<Args>(data)...);
@@ -5,8 +5,6 @@
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
-#include <esp_system.h>
-#include <freertos/FreeRTOS.h>
 
 namespace esp32
 {
@@ -63,7 +61,7 @@ std::string stringify_size(uint64_t bytes, int max_unit)
         }
     }
 
-    return sprintf("%llu %s", static_cast<uint64_t>(std::round(dblBytes)), suffix[i]);
+    return sprintf("%llu %s", static_cast<unsigned long long>(std::round(dblBytes)), suffix[i]);
 }
 
 bool equals_case_insensitive(const std::string &a, const std::string &b)
@@ -90,7 +88,7 @@ std::string str_truncate(const std::string &str, size_t length)
 
 std::string str_until(const char *str, char ch)
 {
-    char *pos = strchr(str, ch);
+    const char *pos = strchr(str, ch);
     return pos == nullptr ? std::string(str) : std::string(str, pos - str);
 }
 
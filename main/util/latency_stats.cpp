@@ -0,0 +1,24 @@
+#include "latency_stats.h"
+#include "logging/logging_tags.h"
+#include <cinttypes>
+#include <esp_log.h>
+
+namespace latency_stats
+{
+constexpr static std::array<const char *, static_cast<size_t>(stage::count)> stage_names = {
+    "uart->frame",
+    "frame->dispatch",
+    "dispatch->spi",
+    "end to end",
+};
+
+void log()
+{
+    for (size_t i = 0; i < histograms.size(); i++)
+    {
+        auto &&histogram = histograms[i];
+        ESP_LOGI(LATENCY_TAG, "%s n=%" PRIu32 " p50<=%" PRIu32 "us p90<=%" PRIu32 "us p99<=%" PRIu32 "us max=%" PRIu32 "us", stage_names[i],
+                 histogram.count(), histogram.percentile(50), histogram.percentile(90), histogram.percentile(99), histogram.max());
+    }
+}
+} // namespace latency_stats
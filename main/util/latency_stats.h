@@ -0,0 +1,38 @@
+#pragma once
+
+#include "log2_histogram.h"
+#include <array>
+#include <chrono>
+#include <stdint.h>
+
+/**
+ * Latency of each stage a feedback frame passes on its way to the LEDs, in microseconds.
+ */
+namespace latency_stats
+{
+enum class stage : uint8_t
+{
+    // uart event received until the frame's CR was split off
+    uart_to_frame,
+    // frame split off until the display event handler ran
+    frame_to_dispatch,
+    // display event handler until the SPI transfer finished, includes render coalescing
+    dispatch_to_spi,
+    // uart event received until the SPI transfer finished
+    end_to_end,
+    count,
+};
+
+inline std::array<log2_histogram, static_cast<size_t>(stage::count)> histograms;
+
+inline void record(stage stage, std::chrono::microseconds latency)
+{
+    const auto value = latency.count() < 0 ? 0 : latency.count();
+    histograms[static_cast<size_t>(stage)].record(value > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(value));
+}
+
+/**
+ * Logs count, percentiles and max of every stage.
+ */
+void log();
+} // namespace latency_stats
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Histogram with power of two buckets: bucket 0 counts zeros, bucket i counts
+ * values in [2^(i-1), 2^i). Recording is a few atomic increments, so it is
+ * cheap enough for hot paths and can be written from any task or core.
+ */
+class log2_histogram
+{
+  public:
+    constexpr static size_t bucket_count = 33;
+
+    void record(uint32_t value)
+    {
+        buckets_[std::bit_width(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+
+        auto max = max_.load(std::memory_order_relaxed);
+        while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    uint32_t count() const
+    {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    uint32_t max() const
+    {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Upper bound of the bucket holding the given percentile, 0 if nothing was recorded.
+     */
+    uint32_t percentile(uint8_t percent) const
+    {
+        const auto total = count();
+        if (!total)
+        {
+            return 0;
+        }
+
+        const uint64_t rank = (static_cast<uint64_t>(total) * percent + 99) / 100;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < bucket_count; i++)
+        {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= rank)
+            {
+                return upper_bound(i);
+            }
+        }
+        return max();
+    }
+
+    uint32_t bucket(size_t index) const
+    {
+        return buckets_[index].load(std::memory_order_relaxed);
+    }
+
+    static constexpr uint32_t upper_bound(size_t index)
+    {
+        return index == 0 ? 0 : static_cast<uint32_t>((uint64_t{1} << index) - 1);
+    }
+
+  private:
+    std::array<std::atomic<uint32_t>, bucket_count> buckets_{};
+    std::atomic<uint32_t> count_{0};
+    std::atomic<uint32_t> max_{0};
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esp32
+{
+/**
+ * Streaming decoder for heatshrink compressed data, e.g. produced by
+ * `heatshrink -e -w 10 -l 5 image.bin image.hs`.
+ *
+ * The stream is a sequence of bit fields, most significant bit first. A 1 tag
+ * bit is followed by an 8 bit literal, a 0 tag bit by a back reference of
+ * WindowBits giving the distance - 1 and LookaheadBits giving the length - 1.
+ * Input can be fed in chunks of any size, the only memory used is the
+ * 2^WindowBits byte history window.
+ */
+template <uint8_t WindowBits, uint8_t LookaheadBits> class lzss_decoder
+{
+    static_assert(WindowBits >= 4 && WindowBits <= 15);
+    static_assert(LookaheadBits >= 3 && LookaheadBits < WindowBits);
+
+  public:
+    constexpr static size_t window_size = size_t{1} << WindowBits;
+
+    /**
+     * Decodes as much of the input as possible and passes every output byte to output(uint8_t).
+     * Fields split across calls are kept and completed by the next one.
+     */
+    template <typename Output> void decode(std::span<const uint8_t> input, Output &&output)
+    {
+        auto next = input.begin();
+        const auto pull = [&](uint8_t bits) {
+            while (bit_count_ < bits)
+            {
+                if (next == input.end())
+                {
+                    return false;
+                }
+                bits_ = (bits_ << 8) | *next++;
+                bit_count_ += 8;
+            }
+            return true;
+        };
+        const auto take = [this](uint8_t bits) {
+            bit_count_ -= bits;
+            const uint32_t value = (bits_ >> bit_count_) & ((uint32_t{1} << bits) - 1);
+            bits_ &= (uint32_t{1} << bit_count_) - 1;
+            return value;
+        };
+
+        while (true)
+        {
+            switch (state_)
+            {
+            case state::tag:
+                if (!pull(1))
+                {
+                    return;
+                }
+                state_ = take(1) ? state::literal : state::distance;
+                break;
+
+            case state::literal:
+                if (!pull(8))
+                {
+                    return;
+                }
+                emit(static_cast<uint8_t>(take(8)), output);
+                state_ = state::tag;
+                break;
+
+            case state::distance:
+                if (!pull(WindowBits))
+                {
+                    return;
+                }
+                distance_ = take(WindowBits) + 1;
+                state_ = state::length;
+                break;
+
+            case state::length:
+                if (!pull(LookaheadBits))
+                {
+                    return;
+                }
+                for (auto length = take(LookaheadBits) + 1; length > 0; length--)
+                {
+                    emit(window_[(head_ - distance_) & (window_size - 1)], output);
+                }
+                state_ = state::tag;
+                break;
+            }
+        }
+    }
+
+    /**
+     * True if the input seen so far ends on a complete symbol, ignoring the zero bits padding the last byte.
+     */
+    bool is_complete() const
+    {
+        if (bit_count_ >= 8 || bits_ != 0)
+        {
+            return false;
+        }
+        return state_ == state::tag || state_ == state::distance;
+    }
+
+  private:
+    enum class state : uint8_t
+    {
+        tag,
+        literal,
+        distance,
+        length,
+    };
+
+    // heatshrink starts with a zeroed window, so early back references may point before the first byte
+    std::array<uint8_t, window_size> window_{};
+    size_t head_{0};
+    uint32_t bits_{0};
+    uint8_t bit_count_{0};
+    state state_{state::tag};
+    uint16_t distance_{0};
+
+    template <typename Output> void emit(uint8_t value, Output &output)
+    {
+        window_[head_ & (window_size - 1)] = value;
+        head_++;
+        output(value);
+    }
+};
+} // namespace esp32
@@ -1,6 +1,8 @@
 #include "util/ota.h"
 
 #include "logging/logging_tags.h"
+#include "util/timer/timer.h"
+#include <algorithm>
 #include <cstring>
 #include <esp_err.h>
 #include <esp_log.h>
@@ -13,10 +15,15 @@ namespace esp32
 
 #define CHECK_THROW_OTA(error_, message) CHECK_THROW(error_, ota_exception)
 
-ota_updator::ota_updator(const std::array<uint8_t, 32> &expected_sha256) : expected_sha256_(expected_sha256)
+ota_updator::ota_updator(const std::array<uint8_t, 32> &expected_sha256, encoding input_encoding) : expected_sha256_(expected_sha256)
 {
     ESP_LOGI(OPERATIONS_TAG, "OTA update started");
 
+    if (input_encoding == encoding::lzss)
+    {
+        decompression_ = std::make_unique<decompression>();
+    }
+
     update_partition_ = esp_ota_get_next_update_partition(NULL);
     if (update_partition_ == NULL)
     {
@@ -37,39 +44,105 @@ void ota_updator::write(const uint8_t *data, size_t size)
         CHECK_THROW_OTA(ESP_ERR_NOT_SUPPORTED, "No OTA in progress");
     }
 
-    const esp_err_t ret = esp_ota_write(handle_, data, size);
+    const esp_err_t ret = write2(data, size);
     CHECK_THROW_OTA(ret, "Failed to write OTA data");
 }
 
 esp_err_t ota_updator::write2(const uint8_t *data, size_t size) noexcept
 {
-    return esp_ota_write(handle_, data, size);
+    if (decompression_)
+    {
+        return decompress(data, size);
+    }
+    return write_image(data, size);
+}
+
+esp_err_t ota_updator::write_image(const uint8_t *data, size_t size) noexcept
+{
+    try
+    {
+        const auto start = esp32::timer::get_time();
+        image_hash_.update(data, size);
+        hash_time_ += esp32::timer::get_time() - start;
+    }
+    catch (const std::exception &)
+    {
+        return ESP_FAIL;
+    }
+
+    const esp_err_t ret = esp_ota_write(handle_, data, size);
+    if (ret == ESP_OK)
+    {
+        image_size_ += size;
+    }
+    return ret;
+}
+
+esp_err_t ota_updator::decompress(const uint8_t *data, size_t size) noexcept
+{
+    auto &state = *decompression_;
+    if (state.error != ESP_OK)
+    {
+        return state.error;
+    }
+
+    state.stream.decode(std::span(data, size), [this, &state](uint8_t value) {
+        state.output[state.output_size++] = value;
+        if (state.output_size == state.output.size())
+        {
+            flush_decompressed();
+        }
+    });
+    return state.error;
+}
+
+esp_err_t ota_updator::flush_decompressed() noexcept
+{
+    auto &state = *decompression_;
+    if (state.error == ESP_OK && state.output_size)
+    {
+        state.error = write_image(state.output.data(), state.output_size);
+    }
+    state.output_size = 0;
+    return state.error;
 }
 
-void ota_updator::end()
+void ota_updator::end(bool verify_flash)
 {
     if (!handle_)
     {
         CHECK_THROW_OTA(ESP_ERR_NOT_SUPPORTED, "No OTA in progress");
     }
 
+    if (decompression_)
+    {
+        if (!decompression_->stream.is_complete())
+        {
+            CHECK_THROW_OTA(ESP_ERR_INVALID_SIZE, "Compressed OTA stream is truncated");
+        }
+        CHECK_THROW_OTA(flush_decompressed(), "Failed to write OTA data");
+    }
+
     ESP_LOGI(OPERATIONS_TAG, "OTA update completed");
 
     esp_err_t ret = esp_ota_end(handle_);
     CHECK_THROW_OTA(ret, "Failed to end OTA update");
     handle_ = 0;
 
-    uint8_t actual_sha256[32]{};
-    ret = esp_partition_get_sha256(update_partition_, actual_sha256);
-    CHECK_THROW_OTA(ret, "Getting SHA-256 of update failed");
-
-    if (memcmp(expected_sha256_.data(), actual_sha256, 32) != 0)
+    const auto actual_sha256 = image_hash_.finish();
+    if (actual_sha256 != expected_sha256_)
     {
         CHECK_THROW_OTA(ESP_FAIL, "SHA-256 does not match as expected");
     }
     else
     {
-        ESP_LOGI(OPERATIONS_TAG, "SHA256 match after ota");
+        ESP_LOGI(OPERATIONS_TAG, "SHA256 match after ota, %u bytes", static_cast<unsigned>(image_size_));
+        ESP_LOGD(OPERATIONS_TAG, "Hashing while writing took %lld us", static_cast<long long>(hash_time_.count()));
+    }
+
+    if (verify_flash && !verify_written_image())
+    {
+        CHECK_THROW_OTA(ESP_ERR_INVALID_CRC, "SHA-256 of flash does not match written image");
     }
 
     ret = esp_ota_set_boot_partition(update_partition_);
@@ -78,6 +151,26 @@ void ota_updator::end()
     ESP_LOGI(OPERATIONS_TAG, "OTA update successfully updated");
 }
 
+bool ota_updator::verify_written_image()
+{
+    const auto start = esp32::timer::get_time();
+    auto buffer = std::make_unique<std::array<uint8_t, 4096>>();
+    esp32::hash::hash<MBEDTLS_MD_SHA256> flash_hash;
+
+    for (size_t offset = 0; offset < image_size_; offset += buffer->size())
+    {
+        const auto size = std::min(buffer->size(), image_size_ - offset);
+        const auto ret = esp_partition_read(update_partition_, offset, buffer->data(), size);
+        CHECK_THROW_OTA(ret, "Failed to read back update partition");
+        flash_hash.update(buffer->data(), size);
+    }
+
+    const auto matches = flash_hash.finish() == expected_sha256_;
+    ESP_LOGD(OPERATIONS_TAG, "Reading back and hashing %u bytes took %lld us", static_cast<unsigned>(image_size_),
+             static_cast<long long>((esp32::timer::get_time() - start).count()));
+    return matches;
+}
+
 void ota_updator::abort()
 {
     ESP_LOGI(OPERATIONS_TAG, "OTA update aborted");
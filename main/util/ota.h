@@ -1,20 +1,41 @@
 #pragma once
 
 #include "util/exceptions.h"
+#include "util/hash/hash.h"
+#include "util/lzss_decoder.h"
 #include "util/noncopyable.h"
 #include <array>
+#include <chrono>
 #include <esp_ota_ops.h>
 #include <esp_partition.h>
+#include <memory>
 
 namespace esp32
 {
+/**
+ * Writes an OTA image to the next update partition on the calling task.
+ * Transports use ota_pipeline, which runs these writes on its own task.
+ */
 class ota_updator final : esp32::noncopyable
 {
   public:
-    ota_updator(const std::array<uint8_t, 32> &expected_sha256);
+    enum class encoding : uint8_t
+    {
+        raw,
+        // heatshrink stream, window 10 and lookahead 5 bits
+        lzss,
+    };
+
+    /**
+     * expected_sha256 is of the image file as written to flash, i.e. after decompression.
+     */
+    ota_updator(const std::array<uint8_t, 32> &expected_sha256, encoding input_encoding = encoding::raw);
     void write(const uint8_t *data, size_t size);
     esp_err_t write2(const uint8_t *data, size_t size) noexcept;
-    void end();
+    /**
+     * Checks the SHA-256 hashed while writing, verify_flash additionally reads the written image back and hashes it again.
+     */
+    void end(bool verify_flash = false);
     void abort();
     bool is_running();
 
@@ -22,6 +43,28 @@ class ota_updator final : esp32::noncopyable
     esp_ota_handle_t handle_{0};
     const std::array<uint8_t, 32> expected_sha256_;
     const esp_partition_t *update_partition_{nullptr};
+    esp32::hash::hash<MBEDTLS_MD_SHA256> image_hash_;
+    // spent in image_hash_, logged at debug level to see what hashing costs on the target
+    std::chrono::microseconds hash_time_{0};
+    size_t image_size_{0};
+
+    using decoder = lzss_decoder<10, 5>;
+
+    // decompressed data is collected and written a flash sector at a time
+    typedef struct decompression
+    {
+        decoder stream;
+        std::array<uint8_t, 4096> output;
+        size_t output_size;
+        esp_err_t error;
+    } decompression;
+
+    std::unique_ptr<decompression> decompression_;
+
+    esp_err_t decompress(const uint8_t *data, size_t size) noexcept;
+    esp_err_t flush_decompressed() noexcept;
+    esp_err_t write_image(const uint8_t *data, size_t size) noexcept;
+    bool verify_written_image();
 };
 
 class ota_exception final : public esp_exception
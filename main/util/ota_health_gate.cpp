@@ -0,0 +1,88 @@
+#include "util/ota_health_gate.h"
+
+#include "logging/logging_tags.h"
+#include <esp_log.h>
+#include <esp_ota_ops.h>
+
+namespace esp32
+{
+
+ota_health_gate::ota_health_gate(health_check_t healthy, std::chrono::seconds settle_time, std::chrono::seconds deadline)
+    : healthy_(std::move(healthy)), settle_time_(settle_time), deadline_(deadline), check_timer_(check_timer_fired, this, "ota_health_gate")
+{
+}
+
+void ota_health_gate::begin()
+{
+    if (!is_pending_verify())
+    {
+        return;
+    }
+
+    ESP_LOGW(OPERATIONS_TAG, "New image not confirmed yet, checking health for up to %llds", static_cast<long long>(deadline_.count()));
+    check_timer_.start_periodic(std::chrono::seconds(1));
+}
+
+void ota_health_gate::fail(const char *reason)
+{
+    if (!is_pending_verify())
+    {
+        return;
+    }
+
+    ESP_LOGE(OPERATIONS_TAG, "New image failed (%s), rolling back", reason);
+    const auto err = esp_ota_mark_app_invalid_rollback_and_reboot();
+    // only returns if there is no previous image to go back to
+    ESP_LOGE(OPERATIONS_TAG, "Rollback failed:%s", esp_err_to_name(err));
+}
+
+bool ota_health_gate::is_pending_verify()
+{
+    esp_ota_img_states_t state;
+    const auto running = esp_ota_get_running_partition();
+    return esp_ota_get_state_partition(running, &state) == ESP_OK && state == ESP_OTA_IMG_PENDING_VERIFY;
+}
+
+void ota_health_gate::check_timer_fired(void *arg)
+{
+    reinterpret_cast<ota_health_gate *>(arg)->check();
+}
+
+void ota_health_gate::check()
+{
+    const auto uptime = esp32::timer::get_time();
+    if (uptime < settle_time_)
+    {
+        return;
+    }
+
+    const auto result = healthy_();
+    if (result == health::healthy)
+    {
+        check_timer_.stop_if_active();
+        const auto err = esp_ota_mark_app_valid_cancel_rollback();
+        if (err == ESP_OK)
+        {
+            ESP_LOGW(OPERATIONS_TAG, "New image confirmed");
+        }
+        else
+        {
+            ESP_LOGE(OPERATIONS_TAG, "Confirming image failed:%s", esp_err_to_name(err));
+        }
+    }
+    else if (uptime >= deadline_)
+    {
+        if (result == health::unknown)
+        {
+            if (!deadline_extended_)
+            {
+                ESP_LOGW(OPERATIONS_TAG, "Health of the new image still unknown, keeping it pending");
+                deadline_extended_ = true;
+            }
+            return;
+        }
+        check_timer_.stop_if_active();
+        fail("health check did not pass");
+    }
+}
+} // namespace esp32
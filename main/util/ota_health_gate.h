@@ -0,0 +1,56 @@
+#pragma once
+
+#include "util/noncopyable.h"
+#include "util/timer/timer.h"
+#include <chrono>
+#include <functional>
+
+namespace esp32
+{
+/**
+ * Confirms a freshly updated image once it has proven itself, or rolls back to the previous one.
+ *
+ * After an OTA update the bootloader starts the new image in pending verify
+ * state. The gate marks it valid once it has run for the settle time without
+ * crashing and the health check reports healthy. If the check reports failing
+ * at the deadline, or fail() is called, the device reboots into the previous
+ * image. While the check reports unknown, e.g. because the peer it depends on
+ * is switched off, the deadline does not apply and the image stays pending
+ * until the check decides. A crash or reset before the image is confirmed
+ * leaves it unconfirmed, which the bootloader also rolls back on the next
+ * boot. On an image that is already confirmed the gate does nothing.
+ */
+class ota_health_gate final : esp32::noncopyable
+{
+  public:
+    enum class health : uint8_t
+    {
+        healthy,
+        failing,
+        // can not tell yet, keeps the image pending past the deadline
+        unknown,
+    };
+
+    using health_check_t = std::function<health()>;
+
+    ota_health_gate(health_check_t healthy, std::chrono::seconds settle_time, std::chrono::seconds deadline);
+
+    void begin();
+
+    /**
+     * Rolls back right away if the running image is not confirmed yet, e.g. when start up failed.
+     */
+    static void fail(const char *reason);
+
+  private:
+    const health_check_t healthy_;
+    const std::chrono::seconds settle_time_;
+    const std::chrono::seconds deadline_;
+    esp32::timer::timer check_timer_;
+    bool deadline_extended_{false};
+
+    static bool is_pending_verify();
+    static void check_timer_fired(void *arg);
+    void check();
+};
+} // namespace esp32
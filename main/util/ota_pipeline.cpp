@@ -0,0 +1,153 @@
+#include "util/ota_pipeline.h"
+
+#include "logging/logging_tags.h"
+#include "util/timer/timer.h"
+#include <algorithm>
+#include <cstring>
+#include <esp_log.h>
+
+namespace esp32
+{
+
+ota_pipeline::ota_pipeline(const std::array<uint8_t, 32> &expected_sha256, ota_updator::encoding input_encoding,
+                           progress_callback_t progress_callback)
+    : updator_(expected_sha256, input_encoding), progress_callback_(std::move(progress_callback)),
+      buffers_(std::make_unique<std::array<std::array<uint8_t, chunk_size>, chunk_count>>()), writer_task_([this] { writer_task(); })
+{
+    for (uint8_t i = 0; i < chunk_count; i++)
+    {
+        free_chunks_.enqueue(chunk{i, 0}, 0);
+    }
+}
+
+void ota_pipeline::begin(uint32_t priority, BaseType_t cpu)
+{
+    start_time_us_ = esp32::timer::get_time().count();
+    CHECK_THROW_ESP(writer_task_.spawn_pinned("ota_writer", 1024 * 4, priority, cpu));
+    writer_running_ = true;
+}
+
+void ota_pipeline::write(const uint8_t *data, size_t size, TickType_t timeout)
+{
+    if (!writer_running_)
+    {
+        CHECK_THROW(ESP_ERR_INVALID_STATE, ota_exception);
+    }
+
+    while (size)
+    {
+        CHECK_THROW(write_error_.load(), ota_exception);
+
+        if (!filling_)
+        {
+            chunk free_chunk;
+            if (!free_chunks_.dequeue(free_chunk, timeout))
+            {
+                CHECK_THROW(ESP_ERR_TIMEOUT, ota_exception);
+            }
+            free_chunk.size = 0;
+            filling_ = free_chunk;
+        }
+
+        auto &buffer = (*buffers_)[filling_->index];
+        const auto copy_size = std::min(size, chunk_size - filling_->size);
+        memcpy(buffer.data() + filling_->size, data, copy_size);
+        filling_->size += copy_size;
+        data += copy_size;
+        size -= copy_size;
+        bytes_received_ += copy_size;
+
+        if (filling_->size == chunk_size)
+        {
+            submit(*filling_);
+            filling_.reset();
+        }
+    }
+}
+
+void ota_pipeline::end(bool verify_flash)
+{
+    if (filling_)
+    {
+        submit(*filling_);
+        filling_.reset();
+    }
+    drain();
+
+    CHECK_THROW(write_error_.load(), ota_exception);
+    updator_.end(verify_flash);
+
+    ESP_LOGI(OPERATIONS_TAG, "OTA pipeline wrote %u bytes", static_cast<unsigned>(bytes_received_.load()));
+}
+
+void ota_pipeline::abort()
+{
+    if (filling_)
+    {
+        free_chunks_.enqueue(*filling_, 0);
+        filling_.reset();
+    }
+    drain();
+    updator_.abort();
+}
+
+void ota_pipeline::submit(const chunk &value)
+{
+    // holds every chunk plus the end marker, so this never waits
+    filled_chunks_.enqueue(value, portMAX_DELAY);
+}
+
+void ota_pipeline::drain()
+{
+    if (!writer_running_)
+    {
+        return;
+    }
+
+    submit(chunk{0, 0});
+    esp_err_t result;
+    drained_.dequeue(result, portMAX_DELAY);
+    writer_running_ = false;
+}
+
+void ota_pipeline::writer_task()
+{
+    do
+    {
+        chunk filled;
+        filled_chunks_.dequeue(filled, portMAX_DELAY);
+
+        if (filled.size == 0)
+        {
+            drained_.enqueue(write_error_.load(), portMAX_DELAY);
+            continue;
+        }
+
+        // after a failure chunks are only handed back, so the caller is not left blocked
+        if (write_error_.load() == ESP_OK)
+        {
+            const auto result = updator_.write2((*buffers_)[filled.index].data(), filled.size);
+            if (result != ESP_OK)
+            {
+                ESP_LOGE(OPERATIONS_TAG, "OTA write failed: %s", esp_err_to_name(result));
+                write_error_ = result;
+            }
+            else
+            {
+                bytes_written_ += filled.size;
+                if (progress_callback_)
+                {
+                    const auto elapsed_us = std::max<int64_t>(esp32::timer::get_time().count() - start_time_us_, 1);
+                    progress_callback_(progress{
+                        .bytes_received = bytes_received_.load(),
+                        .bytes_written = bytes_written_,
+                        .bytes_per_second = static_cast<uint32_t>(static_cast<int64_t>(bytes_written_) * 1000 * 1000 / elapsed_us),
+                    });
+                }
+            }
+        }
+
+        free_chunks_.enqueue(filled, portMAX_DELAY);
+    } while (true);
+}
+} // namespace esp32
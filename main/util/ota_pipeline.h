@@ -0,0 +1,104 @@
+#pragma once
+
+#include "util/noncopyable.h"
+#include "util/ota.h"
+#include "util/static_queue.h"
+#include "util/task_wrapper.h"
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+
+namespace esp32
+{
+/**
+ * Receives an OTA image and writes it to flash on a background task, the entry point for transports.
+ *
+ * Received data is copied into one of a few preallocated chunks, full chunks
+ * are written through an ota_updator by the writer task while the caller fills
+ * the next one. When all chunks are waiting for flash, write() blocks until
+ * one is free, which pushes back on the transport instead of buffering without
+ * bound.
+ */
+class ota_pipeline final : esp32::noncopyable
+{
+  public:
+    constexpr static size_t chunk_size = 4096;
+    constexpr static size_t chunk_count = 3;
+
+    typedef struct progress
+    {
+        size_t bytes_received;
+        size_t bytes_written;
+        uint32_t bytes_per_second;
+    } progress;
+
+    /**
+     * Called on the writer task after every chunk written to flash.
+     */
+    using progress_callback_t = std::function<void(const progress &)>;
+
+    /**
+     * Starts the update, see ota_updator.
+     */
+    ota_pipeline(const std::array<uint8_t, 32> &expected_sha256, ota_updator::encoding input_encoding = ota_updator::encoding::raw,
+                 progress_callback_t progress_callback = {});
+
+    void begin(uint32_t priority = esp32::task::default_priority, BaseType_t cpu = tskNO_AFFINITY);
+
+    /**
+     * Copies the data into the pipeline, blocks while all chunks are in use.
+     * Throws if the writer task failed or no chunk got free within the timeout.
+     */
+    void write(const uint8_t *data, size_t size, TickType_t timeout = portMAX_DELAY);
+
+    /**
+     * Waits for all data to be written and ends the update, see ota_updator::end.
+     */
+    void end(bool verify_flash = false);
+
+    /**
+     * Drops what is not yet written and aborts the update.
+     */
+    void abort();
+
+    bool is_running()
+    {
+        return updator_.is_running();
+    }
+
+  private:
+    typedef struct chunk
+    {
+        uint8_t index;
+        // 0 marks the end of the data
+        uint16_t size;
+    } chunk;
+
+    ota_updator updator_;
+    const progress_callback_t progress_callback_;
+    std::unique_ptr<std::array<std::array<uint8_t, chunk_size>, chunk_count>> buffers_;
+
+    static_queue<chunk, chunk_count> free_chunks_;
+    static_queue<chunk, chunk_count + 1> filled_chunks_;
+    static_queue<esp_err_t, 1> drained_;
+
+    // only used by the caller of write
+    std::optional<chunk> filling_;
+    bool writer_running_{false};
+
+    std::atomic<size_t> bytes_received_{0};
+    std::atomic<esp_err_t> write_error_{ESP_OK};
+    // only used by the writer task
+    size_t bytes_written_{0};
+    int64_t start_time_us_{0};
+
+    // declared last so it is stopped before the queues it waits on are deleted
+    esp32::task writer_task_;
+
+    void writer_task();
+    void submit(const chunk &value);
+    void drain();
+};
+} // namespace esp32
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <stddef.h>
+#include <stdexcept>
+#include <stdint.h>
+#include <string_view>
+
+namespace esp32
+{
+template <typename H> struct prefix_handler
+{
+    std::string_view prefix;
+    H handler;
+};
+
+namespace detail
+{
+/**
+ * Two level perfect hash (hash and displace) over up to Capacity distinct 32 bit keys.
+ *
+ * Every key hashes to a bucket of about two keys, every bucket stores the
+ * displacement that moves its keys into free slots. Buckets are placed largest
+ * first, so the search stays short even for hundreds of keys.
+ */
+template <size_t Capacity> class displaced_hash
+{
+  public:
+    // about 80% load
+    constexpr static size_t slot_count = std::bit_ceil(Capacity + Capacity / 4 + 1);
+
+    static_assert(Capacity > 0 && Capacity < UINT16_MAX, "key count out of range");
+
+    /**
+     * Finds the displacements for the first count keys and returns the slot of each of them.
+     */
+    consteval std::array<uint16_t, Capacity> build(const std::array<uint32_t, Capacity> &keys, size_t count)
+    {
+        std::array<uint16_t, Capacity> order{};
+        std::array<uint16_t, bucket_count> bucket_sizes{};
+        for (size_t i = 0; i < count; i++)
+        {
+            order[i] = static_cast<uint16_t>(i);
+            bucket_sizes[bucket_index(keys[i])]++;
+        }
+
+        // largest buckets first, they are the hardest to place while slots are still free
+        std::sort(order.begin(), order.begin() + count, [&](uint16_t a, uint16_t b) {
+            const auto bucket_a = bucket_index(keys[a]);
+            const auto bucket_b = bucket_index(keys[b]);
+            return bucket_sizes[bucket_a] != bucket_sizes[bucket_b] ? bucket_sizes[bucket_a] > bucket_sizes[bucket_b] : bucket_a < bucket_b;
+        });
+
+        std::array<bool, slot_count> used{};
+        std::array<uint16_t, Capacity> key_slots{};
+        size_t begin = 0;
+        while (begin < count)
+        {
+            const auto bucket = bucket_index(keys[order[begin]]);
+            auto end = begin;
+            while (end < count && bucket_index(keys[order[end]]) == bucket)
+            {
+                end++;
+            }
+            displacements_[bucket] = place_bucket(keys, order, begin, end, used);
+            for (auto i = begin; i < end; i++)
+            {
+                const auto slot = slot_index(keys[order[i]], displacements_[bucket]);
+                used[slot] = true;
+                key_slots[order[i]] = static_cast<uint16_t>(slot);
+            }
+            begin = end;
+        }
+        return key_slots;
+    }
+
+    /**
+     * The slot of key if it was one of the keys built with, otherwise some slot that has to be checked by the caller.
+     */
+    constexpr size_t slot(uint32_t key) const
+    {
+        return slot_index(key, displacements_[bucket_index(key)]);
+    }
+
+  private:
+    // about two keys per bucket
+    constexpr static size_t bucket_count = std::bit_ceil(Capacity / 2 + 1);
+    constexpr static uint32_t max_displacement = UINT16_MAX;
+
+    std::array<uint16_t, bucket_count> displacements_{};
+
+    // multiplicative hashing, the high bits of the product depend on all bits of the key
+    constexpr static size_t bucket_index(uint32_t key)
+    {
+        return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15) >> 32) & (bucket_count - 1);
+    }
+
+    constexpr static size_t slot_index(uint32_t key, uint16_t displacement)
+    {
+        return static_cast<size_t>(((key ^ (displacement * 0x85EBCA6B)) * uint64_t{0xC2B2AE3D27D4EB4F}) >> 40) & (slot_count - 1);
+    }
+
+    consteval static uint16_t place_bucket(const std::array<uint32_t, Capacity> &keys, const std::array<uint16_t, Capacity> &order,
+                                           size_t begin, size_t end, const std::array<bool, slot_count> &used)
+    {
+        for (uint32_t displacement = 0; displacement <= max_displacement; displacement++)
+        {
+            bool fits = true;
+            for (auto i = begin; fits && i < end; i++)
+            {
+                const auto index = slot_index(keys[order[i]], static_cast<uint16_t>(displacement));
+                fits = !used[index];
+                // keys of the same bucket must not collide with each other either
+                for (auto j = begin; fits && j < i; j++)
+                {
+                    fits = slot_index(keys[order[j]], static_cast<uint16_t>(displacement)) != index;
+                }
+            }
+            if (fits)
+            {
+                return static_cast<uint16_t>(displacement);
+            }
+        }
+        throw std::logic_error("no perfect hash found");
+    }
+};
+} // namespace detail
+
+/**
+ * Maps a command to the handler registered for its longest matching prefix.
+ *
+ * The table is built at compile time from two perfect hashes. The first one
+ * maps the command group, the first two characters (e.g. "MV", "PS", "Z2"), to
+ * the lengths of the longer prefixes registered in that group. The second one
+ * maps every longer prefix to its single entry. A lookup hashes the command
+ * once, position by position, and then checks one slot per registered length,
+ * longest first, so it takes time in the order of the prefix length no matter
+ * how many prefixes share a group. Prefixes must be 2 to 31 characters long and
+ * unique.
+ */
+template <typename H, size_t N> class prefix_dispatch
+{
+  public:
+    consteval prefix_dispatch(const std::array<prefix_handler<H>, N> &handlers) : handlers_(handlers)
+    {
+        std::array<uint32_t, N> group_keys{};
+        std::array<uint32_t, N> prefix_keys{};
+        size_t group_count = 0;
+        size_t prefix_count = 0;
+        for (auto &&entry : handlers_)
+        {
+            if (entry.prefix.size() < group_size || entry.prefix.size() > max_prefix_size)
+            {
+                throw std::logic_error("prefix length out of range");
+            }
+
+            const auto key = group_key(entry.prefix);
+            if (std::find(group_keys.begin(), group_keys.begin() + group_count, key) == group_keys.begin() + group_count)
+            {
+                group_keys[group_count++] = key;
+            }
+            if (entry.prefix.size() > group_size)
+            {
+                const auto hash = prefix_hash(entry.prefix);
+                if (std::find(prefix_keys.begin(), prefix_keys.begin() + prefix_count, hash) != prefix_keys.begin() + prefix_count)
+                {
+                    throw std::logic_error("duplicate prefix or hash collision");
+                }
+                prefix_keys[prefix_count++] = hash;
+            }
+        }
+
+        const auto group_slots = group_hash_.build(group_keys, group_count);
+        for (size_t i = 0; i < group_count; i++)
+        {
+            groups_[group_slots[i]].key = static_cast<uint16_t>(group_keys[i]);
+        }
+
+        const auto prefix_slots = prefix_hash_.build(prefix_keys, prefix_count);
+        size_t prefix_index = 0;
+        for (size_t i = 0; i < N; i++)
+        {
+            const auto prefix = handlers_[i].prefix;
+            auto &group = groups_[group_hash_.slot(group_key(prefix))];
+            if (prefix.size() == group_size)
+            {
+                if (group.entry != no_entry)
+                {
+                    throw std::logic_error("duplicate prefix");
+                }
+                group.entry = static_cast<uint16_t>(i);
+            }
+            else
+            {
+                group.lengths |= uint32_t{1} << prefix.size();
+                prefixes_[prefix_slots[prefix_index]] = {prefix_keys[prefix_index], static_cast<uint16_t>(i)};
+                prefix_index++;
+            }
+        }
+    }
+
+    /**
+     * Returns the entry with the longest prefix of command, nullptr if there is none.
+     */
+    constexpr const prefix_handler<H> *find(std::string_view command) const
+    {
+        if (command.size() < group_size)
+        {
+            return nullptr;
+        }
+
+        const auto key = group_key(command);
+        const auto &group = groups_[group_hash_.slot(key)];
+        if (group.key != key)
+        {
+            return nullptr;
+        }
+
+        // only lengths the command is long enough for
+        auto lengths = group.lengths;
+        if (command.size() < max_prefix_size)
+        {
+            lengths &= (uint32_t{2} << command.size()) - 1;
+        }
+
+        if (lengths)
+        {
+            std::array<uint32_t, max_prefix_size + 1> hashes;
+            const auto longest = static_cast<size_t>(std::bit_width(lengths) - 1);
+            uint32_t hash = 0;
+            for (size_t i = 0; i < longest; i++)
+            {
+                hash = hash_step(hash, command[i]);
+                hashes[i + 1] = hash;
+            }
+
+            do
+            {
+                const auto length = static_cast<size_t>(std::bit_width(lengths) - 1);
+                lengths &= ~(uint32_t{1} << length);
+                const auto &slot = prefixes_[prefix_hash_.slot(hashes[length])];
+                if (slot.hash == hashes[length] && slot.entry != no_entry && command.starts_with(handlers_[slot.entry].prefix))
+                {
+                    return &handlers_[slot.entry];
+                }
+            } while (lengths);
+        }
+
+        return group.entry != no_entry ? &handlers_[group.entry] : nullptr;
+    }
+
+  private:
+    constexpr static size_t group_size = 2;
+    constexpr static size_t max_prefix_size = 31;
+    constexpr static uint16_t no_entry = UINT16_MAX;
+
+    struct group_slot
+    {
+        // 0 can not be a valid group so it marks an empty slot
+        uint16_t key{0};
+        // the entry with the two character prefix, if there is one
+        uint16_t entry{no_entry};
+        // bit n is set if a prefix of length n is registered in this group
+        uint32_t lengths{0};
+    };
+
+    struct prefix_slot
+    {
+        uint32_t hash{0};
+        uint16_t entry{no_entry};
+    };
+
+    std::array<prefix_handler<H>, N> handlers_;
+    detail::displaced_hash<N> group_hash_{};
+    detail::displaced_hash<N> prefix_hash_{};
+    std::array<group_slot, detail::displaced_hash<N>::slot_count> groups_{};
+    std::array<prefix_slot, detail::displaced_hash<N>::slot_count> prefixes_{};
+
+    constexpr static uint16_t group_key(std::string_view command)
+    {
+        return static_cast<uint16_t>((static_cast<uint8_t>(command[0]) << 8) | static_cast<uint8_t>(command[1]));
+    }
+
+    // computed one character at a time so find gets the hash of every prefix length in one pass, the
+    // displaced hash mixes it further; collisions between registered prefixes are rejected at compile time
+    constexpr static uint32_t hash_step(uint32_t hash, char value)
+    {
+        return std::rotl(hash, 5) ^ static_cast<uint8_t>(value);
+    }
+
+    constexpr static uint32_t prefix_hash(std::string_view prefix)
+    {
+        uint32_t hash = 0;
+        for (auto value : prefix)
+        {
+            hash = hash_step(hash, value);
+        }
+        return hash;
+    }
+};
+
+} // namespace esp32
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+/**
+ * Lock free circular buffer for exactly one producer and one consumer task,
+ * which may run on different cores.
+ *
+ * Uses the same inline storage as circular_buffer but the producer only
+ * writes the tail index and the consumer only writes the head index, so no
+ * mutex is needed. Unlike circular_buffer, pushing into a full buffer fails
+ * instead of overwriting, since the producer must never touch a slot the
+ * consumer may be reading.
+ */
+template <typename T, size_t S>
+    requires std::is_trivially_copyable_v<T>
+class spsc_circular_buffer
+{
+  public:
+    static_assert(std::has_single_bit(S), "capacity must be a power of two");
+
+    /**
+     * The buffer capacity: read only as it cannot ever change.
+     */
+    static constexpr size_t capacity = S;
+
+    constexpr spsc_circular_buffer() = default;
+
+    /**
+     * Disables copy constructor
+     */
+    spsc_circular_buffer(const spsc_circular_buffer &) = delete;
+    spsc_circular_buffer(spsc_circular_buffer &&) = delete;
+
+    /**
+     * Disables assignment operator
+     */
+    spsc_circular_buffer &operator=(const spsc_circular_buffer &) = delete;
+    spsc_circular_buffer &operator=(spsc_circular_buffer &&) = delete;
+
+    /**
+     * Adds an element to the end of buffer. Producer only.
+     * Returns `false` if the buffer is full, the element is not added.
+     */
+    bool push(const T &value)
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == capacity)
+        {
+            return false;
+        }
+        buffer_[tail & mask] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Removes the element at the beginning of the buffer. Consumer only.
+     * Returns `false` if the buffer is empty.
+     */
+    bool pop(T &value)
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        value = buffer_[head & mask];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Returns how many elements are stored in the buffer. Only a snapshot when
+     * called from the other side.
+     */
+    size_t size() const
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    bool is_empty() const
+    {
+        return size() == 0;
+    }
+
+  private:
+    static constexpr size_t mask = S - 1;
+
+    T buffer_[S]{};
+    // indexes run freely and wrap, they are masked on access
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
+};
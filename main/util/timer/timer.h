@@ -4,8 +4,6 @@
 #include "util/noncopyable.h"
 #include <chrono>
 #include <esp_timer.h>
-#include <functional>
-#include <string>
 
 namespace esp32::timer
 {
@@ -32,15 +30,22 @@ static inline std::chrono::microseconds get_next_alarm()
 /**
  * @brief
  * A timer using the esp_timer component which can be started either as one-shot timer or periodically.
+ *
+ * The timer does not allocate besides the esp_timer handle created once in the constructor, so it is meant to be
+ * created once and then started and stopped as often as needed.
  */
 class timer : esp32::noncopyable
 {
   public:
+    using callback_t = esp_timer_cb_t;
+
     /**
-     * @param timeout_cb The timeout callback.
-     * @param timer_name The name of the timer (optional). This is for debugging using \c esp_timer_dump().
+     * @param timeout_cb The timeout callback, called from the esp_timer task.
+     * @param arg The argument passed to the callback.
+     * @param timer_name The name of the timer. This is for debugging using \c esp_timer_dump(), it must have static
+     *                   storage duration.
      */
-    timer(const std::function<void()> &timeout_cb, const std::string &timer_name);
+    timer(callback_t timeout_cb, void *arg, const char *timer_name);
 
     /**
      * Stop the timer if necessary and delete it.
@@ -95,26 +100,68 @@ class timer : esp32::noncopyable
         CHECK_THROW_ESP(esp_timer_stop(timer_handle_));
     }
 
-  private:
     /**
-     * Internal callback to hook into esp_timer component.
+     * @brief Stop the timer if it is running, otherwise do nothing.
+     *
+     * A one-shot timer can expire at any moment, so instead of checking \c is_active() first the
+     * ESP_ERR_INVALID_STATE of a timer that is not running is ignored.
      */
-    static void esp_timer_cb(void *arg);
+    inline void stop_if_active()
+    {
+        const auto err = esp_timer_stop(timer_handle_);
+        if (err != ESP_ERR_INVALID_STATE)
+        {
+            CHECK_THROW_ESP(err);
+        }
+    }
 
     /**
-     * Timer instance of the underlying esp_event component.
+     * @brief Restart the timer with a new timeout or period if it is running, otherwise do nothing.
+     *
+     * @return whether the timer was running.
      */
-    esp_timer_handle_t timer_handle_;
+    inline bool restart_if_active(const std::chrono::microseconds &period)
+    {
+        const auto err = esp_timer_restart(timer_handle_, period.count());
+        if (err == ESP_ERR_INVALID_STATE)
+        {
+            return false;
+        }
+        CHECK_THROW_ESP(err);
+        return true;
+    }
 
     /**
-     * Callback which will be called once the timer triggers.
+     * @brief Restart the one-shot timer with a new timeout, or start it if it is not running (anymore).
+     *
+     * Safe to call from several tasks, a timer another task started in between is left running.
      */
-    std::function<void()> timeout_cb_;
+    inline void restart_one_shot(const std::chrono::microseconds &timeout)
+    {
+        if (restart_if_active(timeout))
+        {
+            return;
+        }
+        const auto err = esp_timer_start_once(timer_handle_, timeout.count());
+        if (err != ESP_ERR_INVALID_STATE)
+        {
+            CHECK_THROW_ESP(err);
+        }
+    }
 
     /**
-     * Name of the timer, will be passed to the underlying timer framework and is used for debugging.
+     * @brief Returns whether the timer is currently started.
+     */
+    inline bool is_active() const
+    {
+        return esp_timer_is_active(timer_handle_);
+    }
+
+  private:
+    /**
+     * Timer instance of the underlying esp_event component.
      */
-    const std::string name_;
+    esp_timer_handle_t timer_handle_{};
 };
 
 } // namespace esp32::timer
\ No newline at end of file